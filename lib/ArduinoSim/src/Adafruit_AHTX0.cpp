@@ -0,0 +1,59 @@
+#include "Adafruit_AHTX0.h"
+#include "Arduino.h"
+
+bool Adafruit_AHTX0::writeCommand(const uint8_t* cmd, size_t len) {
+    _wire->beginTransmission(_addr);
+    _wire->write(cmd, len);
+    return _wire->endTransmission() == 0;
+}
+
+uint8_t Adafruit_AHTX0::getStatus() {
+    if (_wire->requestFrom(_addr, (size_t)1) != 1) return 0xFF;
+    return (uint8_t)_wire->read();
+}
+
+bool Adafruit_AHTX0::begin(TwoWire* wire, int32_t, uint8_t i2c_address) {
+    _wire = wire;
+    _addr = i2c_address;
+
+    delay(20);   // Датчику нужно 20 мс после подачи питания
+
+    const uint8_t reset[] = { AHTX0_CMD_SOFTRESET };
+    if (!writeCommand(reset, sizeof(reset))) return false;
+    delay(20);
+
+    const uint8_t calibrate[] = { AHTX0_CMD_CALIBRATE, 0x08, 0x00 };
+    if (!writeCommand(calibrate, sizeof(calibrate))) return false;
+    while (getStatus() & AHTX0_STATUS_BUSY) delay(10);
+
+    return (getStatus() & AHTX0_STATUS_CALIBRATED) != 0;
+}
+
+bool Adafruit_AHTX0::getEvent(sensors_event_t* humidity, sensors_event_t* temp) {
+    const uint8_t trigger[] = { AHTX0_CMD_TRIGGER, 0x33, 0x00 };
+    if (!writeCommand(trigger, sizeof(trigger))) return false;
+
+    // То самое ожидание ~80 мс, которое блокирует loop()
+    while (getStatus() & AHTX0_STATUS_BUSY) delay(10);
+
+    uint8_t data[6];
+    if (_wire->requestFrom(_addr, sizeof(data)) != sizeof(data)) return false;
+    for (uint8_t& b : data) b = (uint8_t)_wire->read();
+
+    uint32_t h = ((uint32_t)data[1] << 12) | ((uint32_t)data[2] << 4) | (data[3] >> 4);
+    uint32_t t = (((uint32_t)data[3] & 0x0F) << 16) | ((uint32_t)data[4] << 8) | data[5];
+    _humidity    = (float)h * 100.0f / 0x100000;
+    _temperature = (float)t * 200.0f / 0x100000 - 50.0f;
+
+    if (humidity) {
+        memset(humidity, 0, sizeof(*humidity));
+        humidity->relative_humidity = _humidity;
+        humidity->timestamp = (int32_t)millis();
+    }
+    if (temp) {
+        memset(temp, 0, sizeof(*temp));
+        temp->temperature = _temperature;
+        temp->timestamp = (int32_t)millis();
+    }
+    return true;
+}
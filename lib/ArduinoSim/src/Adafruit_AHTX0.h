@@ -0,0 +1,33 @@
+#ifndef SIM_ADAFRUIT_AHTX0_H
+#define SIM_ADAFRUIT_AHTX0_H
+
+// Повторяет поведение Adafruit_AHTX0 2.0.x, включая блокирующее ожидание
+// конца преобразования (delay(10) в цикле по биту BUSY) внутри getEvent().
+
+#include <Wire.h>
+#include "Adafruit_Sensor.h"
+
+#define AHTX0_I2CADDR_DEFAULT 0x38
+#define AHTX0_CMD_CALIBRATE   0xE1
+#define AHTX0_CMD_TRIGGER     0xAC
+#define AHTX0_CMD_SOFTRESET   0xBA
+#define AHTX0_STATUS_BUSY     0x80
+#define AHTX0_STATUS_CALIBRATED 0x08
+
+class Adafruit_AHTX0 {
+public:
+    bool    begin(TwoWire* wire = &Wire, int32_t sensor_id = 0,
+                  uint8_t i2c_address = AHTX0_I2CADDR_DEFAULT);
+    bool    getEvent(sensors_event_t* humidity, sensors_event_t* temp);
+    uint8_t getStatus();
+
+private:
+    TwoWire* _wire = nullptr;
+    uint8_t  _addr = AHTX0_I2CADDR_DEFAULT;
+    float    _temperature = 0;
+    float    _humidity    = 0;
+
+    bool writeCommand(const uint8_t* cmd, size_t len);
+};
+
+#endif // SIM_ADAFRUIT_AHTX0_H
@@ -0,0 +1,66 @@
+#include "Adafruit_SSD1306.h"
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t,
+                                   uint32_t clkDuring, uint32_t clkAfter)
+    : _wire(twi), _width(w), _height(h),
+      _clkDuring(clkDuring), _clkAfter(clkAfter), _addr(0x3C) {}
+
+bool Adafruit_SSD1306::begin(uint8_t, uint8_t i2caddr, bool, bool periphBegin) {
+    _addr = i2caddr ? i2caddr : 0x3C;
+    if (periphBegin) _wire->begin();
+
+    // Последовательность инициализации — ~25 командных байт
+    static const uint8_t init[] = {
+        SSD1306_DISPLAYOFF, 0xD5, 0x80, 0xA8, 0x3F, 0xD3, 0x00, 0x40,
+        0x8D, 0x14, 0x20, 0x00, 0xA1, 0xC8, 0xDA, 0x12, 0x81, 0xCF,
+        0xD9, 0xF1, 0xDB, 0x40, 0xA4, 0xA6, 0x2E, SSD1306_DISPLAYON,
+    };
+    for (uint8_t c : init) ssd1306_command(c);
+    return true;
+}
+
+void Adafruit_SSD1306::ssd1306_command(uint8_t c) {
+    _wire->setClock(_clkDuring);
+    _wire->beginTransmission(_addr);
+    _wire->write((uint8_t)0x00);
+    _wire->write(c);
+    _wire->endTransmission();
+    _wire->setClock(_clkAfter);
+}
+
+void Adafruit_SSD1306::display() {
+    _wire->setClock(_clkDuring);
+
+    // Окно страниц/колонок
+    static const uint8_t window[] = { 0x22, 0x00, 0xFF, 0x21, 0x00 };
+    _wire->beginTransmission(_addr);
+    _wire->write((uint8_t)0x00);
+    _wire->write(window, sizeof(window));
+    _wire->write((uint8_t)(_width - 1));
+    _wire->endTransmission();
+
+    // Кадровый буфер порциями по 31 байт данных + байт 0x40 (как WIRE_MAX=32)
+    size_t remaining = (size_t)_width * ((_height + 7) / 8);
+    uint8_t chunk[31] = {};
+    while (remaining > 0) {
+        size_t n = remaining < sizeof(chunk) ? remaining : sizeof(chunk);
+        _wire->beginTransmission(_addr);
+        _wire->write((uint8_t)0x40);
+        _wire->write(chunk, n);
+        _wire->endTransmission();
+        remaining -= n;
+    }
+
+    _wire->setClock(_clkAfter);
+    _frames++;
+}
+
+size_t Adafruit_SSD1306::write(uint8_t c) {
+    if (c == '\n') {
+        _cursorX = 0;
+        _cursorY += 8 * _textSize;
+    } else if (c != '\r') {
+        _cursorX += 6 * _textSize;
+    }
+    return 1;
+}
@@ -0,0 +1,61 @@
+#ifndef SIM_ADAFRUIT_SSD1306_H
+#define SIM_ADAFRUIT_SSD1306_H
+
+// SSD1306 + подмножество Adafruit_GFX. Рисование — no-op (кадровый буфер
+// не нужен), а display() гонит 1 КБ по Wire порциями, как настоящая
+// библиотека, поэтому кадр стоит на шине те же ~23 мс при 400 кГц.
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define SSD1306_BLACK   0
+#define SSD1306_WHITE   1
+#define SSD1306_INVERSE 2
+
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_DISPLAYOFF   0xAE
+#define SSD1306_DISPLAYON    0xAF
+
+class Adafruit_SSD1306 : public Print {
+public:
+    Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rst_pin = -1,
+                     uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL);
+
+    bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0,
+               bool reset = true, bool periphBegin = true);
+    void display();
+    void clearDisplay() {}
+    void ssd1306_command(uint8_t c);
+
+    void setTextSize(uint8_t s) { _textSize = s ? s : 1; }
+    void setTextColor(uint16_t c) { (void)c; }
+    void setTextColor(uint16_t c, uint16_t bg) { (void)c; (void)bg; }
+    void setCursor(int16_t x, int16_t y) { _cursorX = x; _cursorY = y; }
+    int16_t getCursorX() const { return _cursorX; }
+    int16_t getCursorY() const { return _cursorY; }
+    void cp437(bool x = true) { (void)x; }
+
+    void drawPixel(int16_t, int16_t, uint16_t) {}
+    void drawLine(int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+    void drawFastHLine(int16_t, int16_t, int16_t, uint16_t) {}
+    void drawFastVLine(int16_t, int16_t, int16_t, uint16_t) {}
+    void drawRect(int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+    void fillRect(int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+
+    using Print::write;
+    size_t write(uint8_t c) override;
+
+    // Сколько кадров реально ушло на матрицу
+    unsigned long frameCount() const { return _frames; }
+
+private:
+    TwoWire* _wire;
+    uint8_t  _width, _height;
+    uint32_t _clkDuring, _clkAfter;
+    uint8_t  _addr;
+    int16_t  _cursorX = 0, _cursorY = 0;
+    uint8_t  _textSize = 1;
+    unsigned long _frames = 0;
+};
+
+#endif // SIM_ADAFRUIT_SSD1306_H
@@ -0,0 +1,19 @@
+#ifndef SIM_ADAFRUIT_SENSOR_H
+#define SIM_ADAFRUIT_SENSOR_H
+
+#include <stdint.h>
+
+typedef struct {
+    int32_t  version;
+    int32_t  sensor_id;
+    int32_t  type;
+    int32_t  reserved0;
+    int32_t  timestamp;
+    union {
+        float temperature;
+        float relative_humidity;
+        float data[4];
+    };
+} sensors_event_t;
+
+#endif // SIM_ADAFRUIT_SENSOR_H
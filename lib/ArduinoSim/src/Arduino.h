@@ -0,0 +1,121 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+// ============================================
+// Arduino-ESP32 core — хост-заглушка для env:native
+// ============================================
+// Покрывает ровно то, что использует прошивка. Время — виртуальное
+// (см. sim.h), GPIO/ADC — модель платы, куча — с учётом выделений.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "WString.h"
+#include "Print.h"
+
+using std::min;
+using std::max;
+
+// Атрибуты размещения на хосте ничего не значат
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define IRAM_ATTR
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t*>(addr))
+#define strlen_P strlen
+#define memcpy_P memcpy
+
+// ESP32-C3 имеет встроенный датчик температуры кристалла
+#define SOC_TEMP_SENSOR_SUPPORTED 1
+
+// --------------------------------------------
+// GPIO / ADC
+// --------------------------------------------
+#define LOW    0x0
+#define HIGH   0x1
+#define INPUT          0x01
+#define OUTPUT         0x03
+#define PULLUP         0x04
+#define INPUT_PULLUP   0x05
+#define PULLDOWN       0x08
+#define INPUT_PULLDOWN 0x09
+
+typedef enum {
+    ADC_0db,
+    ADC_2_5db,
+    ADC_6db,
+    ADC_11db
+} adc_attenuation_t;
+
+void     pinMode(uint8_t pin, uint8_t mode);
+void     digitalWrite(uint8_t pin, uint8_t val);
+int      digitalRead(uint8_t pin);
+void     analogReadResolution(uint8_t bits);
+void     analogSetPinAttenuation(uint8_t pin, adc_attenuation_t attenuation);
+uint16_t analogRead(uint8_t pin);
+uint32_t analogReadMilliVolts(uint8_t pin);
+
+// --------------------------------------------
+// Время
+// --------------------------------------------
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+float temperatureRead();
+
+// Частота CPU (esp32-hal-cpu.h): на C3 — 160/80/40/20/10 МГц
+bool     setCpuFrequencyMhz(uint32_t cpu_freq_mhz);
+uint32_t getCpuFrequencyMhz();
+
+// --------------------------------------------
+// Serial (USB CDC на C3)
+// --------------------------------------------
+class HWCDC : public Print {
+public:
+    void begin(unsigned long baud);
+    void end() {}
+    void flush() {}
+    int  available() { return 0; }
+    int  read() { return -1; }
+    operator bool() const { return true; }
+
+    using Print::write;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+};
+extern HWCDC Serial;
+
+// --------------------------------------------
+// ESP — информация о чипе и куче
+// --------------------------------------------
+class EspClass {
+public:
+    uint32_t    getHeapSize();
+    uint32_t    getFreeHeap();
+    uint32_t    getMinFreeHeap();
+    uint32_t    getMaxAllocHeap();
+    const char* getChipModel() { return "ESP32-C3 (sim)"; }
+    uint8_t     getChipRevision() { return 4; }
+    uint32_t    getCpuFreqMHz();
+    uint32_t    getFlashChipSize() { return 4UL * 1024 * 1024; }
+    const char* getSdkVersion() { return "sim"; }
+    uint32_t    getCycleCount();
+    [[noreturn]] void restart();
+};
+extern EspClass ESP;
+
+// Точки входа скетча
+void setup();
+void loop();
+
+#endif // SIM_ARDUINO_H
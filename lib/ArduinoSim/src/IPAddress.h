@@ -0,0 +1,24 @@
+#ifndef SIM_IPADDRESS_H
+#define SIM_IPADDRESS_H
+
+#include <stdint.h>
+#include "WString.h"
+
+class IPAddress {
+public:
+    IPAddress() : _addr(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : _addr((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+    explicit IPAddress(uint32_t addr) : _addr(addr) {}
+
+    operator uint32_t() const { return _addr; }
+    uint8_t operator[](int i) const { return (uint8_t)(_addr >> (8 * i)); }
+    bool operator==(const IPAddress& rhs) const { return _addr == rhs._addr; }
+
+    String toString() const;
+
+private:
+    uint32_t _addr;
+};
+
+#endif // SIM_IPADDRESS_H
@@ -0,0 +1,86 @@
+#include "Print.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+}
+
+size_t Print::write(const char* str) {
+    return str ? write(str, strlen(str)) : 0;
+}
+
+size_t Print::printf(const char* format, ...) {
+    // Как в ядре ESP32: короткое сообщение — на стеке, длинное — в куче
+    char    loc[64];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(loc, sizeof(loc), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t)len < sizeof(loc)) return write(loc, len);
+
+    char* buf = new char[len + 1];
+    va_start(args, format);
+    vsnprintf(buf, len + 1, format, args);
+    va_end(args);
+    size_t n = write(buf, len);
+    delete[] buf;
+    return n;
+}
+
+size_t Print::print(const __FlashStringHelper* s) {
+    return write(reinterpret_cast<const char*>(s));
+}
+
+size_t Print::print(const String& s) { return write(s.c_str(), s.length()); }
+size_t Print::print(const char* s)   { return write(s); }
+size_t Print::print(char c)          { return write((uint8_t)c); }
+
+static size_t printNumber(Print& p, unsigned long long n, bool negative, int base) {
+    char buf[72];
+    char* str = &buf[sizeof(buf) - 1];
+    *str = 0;
+    if (base < 2) base = 10;
+    do {
+        int d = (int)(n % base);
+        *--str = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+        n /= base;
+    } while (n);
+    if (negative) *--str = '-';
+    return p.write(str);
+}
+
+#define SIM_PRINT_SIGNED(T)                                                    \
+    size_t Print::print(T n, int base) {                                       \
+        if (base == 0) return write((uint8_t)n);                               \
+        bool neg = (base == 10 && n < 0);                                      \
+        return printNumber(*this, neg ? 0ULL - (unsigned long long)n           \
+                                      : (unsigned long long)n, neg, base);     \
+    }
+#define SIM_PRINT_UNSIGNED(T)                                                  \
+    size_t Print::print(T n, int base) {                                       \
+        if (base == 0) return write((uint8_t)n);                               \
+        return printNumber(*this, (unsigned long long)n, false, base);         \
+    }
+
+SIM_PRINT_UNSIGNED(unsigned char)
+SIM_PRINT_SIGNED(int)
+SIM_PRINT_UNSIGNED(unsigned int)
+SIM_PRINT_SIGNED(long)
+SIM_PRINT_UNSIGNED(unsigned long)
+SIM_PRINT_SIGNED(long long)
+SIM_PRINT_UNSIGNED(unsigned long long)
+
+size_t Print::print(double n, int digits) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", digits, n);
+    return write(buf);
+}
+
+size_t Print::println() {
+    return write("\r\n");
+}
@@ -0,0 +1,278 @@
+#include "WString.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <utility>
+
+// --------------------------------------------
+// Конструкторы
+// --------------------------------------------
+String::String(const char* cstr) : _buf(nullptr), _len(0), _cap(0) {
+    if (cstr) copy(cstr, strlen(cstr));
+}
+
+String::String(const char* cstr, unsigned int length) : _buf(nullptr), _len(0), _cap(0) {
+    if (cstr) copy(cstr, length);
+}
+
+String::String(const String& str) : _buf(nullptr), _len(0), _cap(0) {
+    *this = str;
+}
+
+String::String(String&& rval) noexcept : _buf(rval._buf), _len(rval._len), _cap(rval._cap) {
+    rval._buf = nullptr;
+    rval._len = rval._cap = 0;
+}
+
+String::String(const __FlashStringHelper* str)
+    : String(reinterpret_cast<const char*>(str)) {}
+
+String::String(char c) : _buf(nullptr), _len(0), _cap(0) {
+    char buf[2] = { c, 0 };
+    copy(buf, 1);
+}
+
+static void formatInteger(char* buf, size_t size, unsigned long long value,
+                          bool negative, unsigned char base) {
+    char tmp[72];
+    int  n = 0;
+    if (base < 2 || base > 36) base = 10;
+    do {
+        unsigned d = (unsigned)(value % base);
+        tmp[n++] = (char)(d < 10 ? '0' + d : 'a' + d - 10);
+        value /= base;
+    } while (value && n < (int)sizeof(tmp));
+    size_t pos = 0;
+    if (negative && pos + 1 < size) buf[pos++] = '-';
+    while (n > 0 && pos + 1 < size) buf[pos++] = tmp[--n];
+    buf[pos] = 0;
+}
+
+#define SIM_STRING_SIGNED_CTOR(T)                                              \
+    String::String(T value, unsigned char base) : _buf(nullptr), _len(0), _cap(0) { \
+        char buf[72];                                                          \
+        bool neg = (base == 10 && value < 0);                                  \
+        unsigned long long mag = neg ? 0ULL - (unsigned long long)value        \
+                                     : (unsigned long long)value;              \
+        formatInteger(buf, sizeof(buf), mag, neg, base);                       \
+        copy(buf, strlen(buf));                                                \
+    }
+
+#define SIM_STRING_UNSIGNED_CTOR(T)                                            \
+    String::String(T value, unsigned char base) : _buf(nullptr), _len(0), _cap(0) { \
+        char buf[72];                                                          \
+        formatInteger(buf, sizeof(buf), (unsigned long long)value, false, base); \
+        copy(buf, strlen(buf));                                                \
+    }
+
+SIM_STRING_UNSIGNED_CTOR(unsigned char)
+SIM_STRING_SIGNED_CTOR(int)
+SIM_STRING_UNSIGNED_CTOR(unsigned int)
+SIM_STRING_SIGNED_CTOR(long)
+SIM_STRING_UNSIGNED_CTOR(unsigned long)
+SIM_STRING_SIGNED_CTOR(long long)
+SIM_STRING_UNSIGNED_CTOR(unsigned long long)
+
+String::String(float value, unsigned int decimalPlaces)
+    : String((double)value, decimalPlaces) {}
+
+String::String(double value, unsigned int decimalPlaces) : _buf(nullptr), _len(0), _cap(0) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimalPlaces, value);
+    copy(buf, strlen(buf));
+}
+
+String::~String() {
+    invalidate();
+}
+
+// --------------------------------------------
+// Память
+// --------------------------------------------
+void String::invalidate() {
+    if (_buf) ::operator delete[](_buf);
+    _buf = nullptr;
+    _len = _cap = 0;
+}
+
+bool String::grow(unsigned int size) {
+    if (_buf && _cap >= size) return true;
+    char* nb = static_cast<char*>(::operator new[](size + 1));
+    if (_buf) {
+        memcpy(nb, _buf, _len + 1);
+        ::operator delete[](_buf);
+    } else {
+        nb[0] = 0;
+    }
+    _buf = nb;
+    _cap = size;
+    return true;
+}
+
+bool String::reserve(unsigned int size) {
+    return grow(size);
+}
+
+String& String::copy(const char* cstr, unsigned int length) {
+    if (length == 0 && !_buf) return *this;   // Пустая строка не занимает кучу
+    grow(length);
+    memcpy(_buf, cstr, length);
+    _buf[length] = 0;
+    _len = length;
+    return *this;
+}
+
+String& String::operator=(const String& rhs) {
+    if (this == &rhs) return *this;
+    if (rhs._buf) copy(rhs._buf, rhs._len);
+    else invalidate();
+    return *this;
+}
+
+String& String::operator=(String&& rval) noexcept {
+    if (this != &rval) {
+        invalidate();
+        std::swap(_buf, rval._buf);
+        std::swap(_len, rval._len);
+        std::swap(_cap, rval._cap);
+    }
+    return *this;
+}
+
+String& String::operator=(const char* cstr) {
+    if (cstr) copy(cstr, strlen(cstr));
+    else invalidate();
+    return *this;
+}
+
+// --------------------------------------------
+// Конкатенация
+// --------------------------------------------
+bool String::concat(const char* cstr, unsigned int length) {
+    if (!cstr) return false;
+    if (length == 0) return true;
+    unsigned int newLen = _len + length;
+    if (!_buf || newLen > _cap) {
+        // Как в ядре: растём ровно до нужной длины — отсюда и дробление кучи
+        grow(newLen);
+    }
+    memmove(_buf + _len, cstr, length);
+    _len = newLen;
+    _buf[_len] = 0;
+    return true;
+}
+
+bool String::concat(const String& str) {
+    return concat(str.c_str(), str._len);
+}
+
+bool String::concat(const char* cstr) {
+    return cstr ? concat(cstr, strlen(cstr)) : false;
+}
+
+bool String::concat(char c) {
+    return concat(&c, 1);
+}
+
+bool String::concat(int num)           { return concat(String(num)); }
+bool String::concat(unsigned int num)  { return concat(String(num)); }
+bool String::concat(long num)          { return concat(String(num)); }
+bool String::concat(unsigned long num) { return concat(String(num)); }
+bool String::concat(float num)         { return concat(String(num)); }
+bool String::concat(double num)        { return concat(String(num)); }
+
+String operator+(const String& lhs, const String& rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, const char* rhs)   { String s(lhs); s.concat(rhs); return s; }
+String operator+(const char* lhs, const String& rhs)   { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, char rhs)          { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, int rhs)           { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, unsigned int rhs)  { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, long rhs)          { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, unsigned long rhs) { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, float rhs)         { String s(lhs); s.concat(rhs); return s; }
+String operator+(const String& lhs, double rhs)        { String s(lhs); s.concat(rhs); return s; }
+String operator+(String&& lhs, const String& rhs)      { lhs.concat(rhs); return std::move(lhs); }
+String operator+(String&& lhs, const char* rhs)        { lhs.concat(rhs); return std::move(lhs); }
+
+// --------------------------------------------
+// Сравнение и поиск
+// --------------------------------------------
+bool String::equals(const String& s) const {
+    return _len == s._len && strcmp(c_str(), s.c_str()) == 0;
+}
+
+bool String::equals(const char* cstr) const {
+    return strcmp(c_str(), cstr ? cstr : "") == 0;
+}
+
+bool String::equalsIgnoreCase(const String& s) const {
+    return _len == s._len && strcasecmp(c_str(), s.c_str()) == 0;
+}
+
+bool String::startsWith(const String& prefix) const {
+    return prefix._len <= _len && strncmp(c_str(), prefix.c_str(), prefix._len) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    return suffix._len <= _len &&
+           strcmp(c_str() + _len - suffix._len, suffix.c_str()) == 0;
+}
+
+char String::charAt(unsigned int index) const {
+    return index < _len ? _buf[index] : 0;
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+    if (fromIndex >= _len) return -1;
+    const char* p = strchr(c_str() + fromIndex, ch);
+    return p ? (int)(p - c_str()) : -1;
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+    if (fromIndex >= _len) return -1;
+    const char* p = strstr(c_str() + fromIndex, str.c_str());
+    return p ? (int)(p - c_str()) : -1;
+}
+
+String String::substring(unsigned int beginIndex) const {
+    return substring(beginIndex, _len);
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if (beginIndex > endIndex) std::swap(beginIndex, endIndex);
+    if (beginIndex >= _len) return String();
+    if (endIndex > _len) endIndex = _len;
+    return String(c_str() + beginIndex, endIndex - beginIndex);
+}
+
+// --------------------------------------------
+// Модификация и преобразование
+// --------------------------------------------
+void String::trim() {
+    if (!_buf || _len == 0) return;
+    unsigned int begin = 0;
+    while (begin < _len && isspace((unsigned char)_buf[begin])) begin++;
+    unsigned int end = _len;
+    while (end > begin && isspace((unsigned char)_buf[end - 1])) end--;
+    _len = end - begin;
+    if (begin > 0) memmove(_buf, _buf + begin, _len);
+    _buf[_len] = 0;
+}
+
+void String::toLowerCase() {
+    for (unsigned int i = 0; i < _len; i++) _buf[i] = (char)tolower((unsigned char)_buf[i]);
+}
+
+void String::toUpperCase() {
+    for (unsigned int i = 0; i < _len; i++) _buf[i] = (char)toupper((unsigned char)_buf[i]);
+}
+
+long String::toInt() const {
+    return _buf ? atol(_buf) : 0;
+}
+
+float String::toFloat() const {
+    return _buf ? (float)atof(_buf) : 0.0f;
+}
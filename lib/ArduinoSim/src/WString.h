@@ -0,0 +1,104 @@
+#ifndef SIM_WSTRING_H
+#define SIM_WSTRING_H
+
+// Arduino String для хост-сборки. Намеренно без SSO: каждое расширение —
+// отдельное выделение через operator new, чтобы счётчик sim::heap()
+// показывал худший случай фрагментации, а не прятал короткие строки.
+
+#include <stddef.h>
+#include <stdint.h>
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+class String {
+public:
+    String(const char* cstr = "");
+    String(const char* cstr, unsigned int length);
+    String(const String& str);
+    String(String&& rval) noexcept;
+    String(const __FlashStringHelper* str);
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimalPlaces = 2);
+    explicit String(double value, unsigned int decimalPlaces = 2);
+    ~String();
+
+    String& operator=(const String& rhs);
+    String& operator=(String&& rval) noexcept;
+    String& operator=(const char* cstr);
+
+    bool reserve(unsigned int size);
+    unsigned int length() const { return _len; }
+    bool isEmpty() const { return _len == 0; }
+    const char* c_str() const { return _buf ? _buf : ""; }
+
+    bool concat(const String& str);
+    bool concat(const char* cstr);
+    bool concat(const char* cstr, unsigned int length);
+    bool concat(char c);
+    bool concat(int num);
+    bool concat(unsigned int num);
+    bool concat(long num);
+    bool concat(unsigned long num);
+    bool concat(float num);
+    bool concat(double num);
+
+    template <typename T>
+    String& operator+=(const T& rhs) { concat(rhs); return *this; }
+    String& operator+=(const char* cstr) { concat(cstr); return *this; }
+
+    bool equals(const String& s) const;
+    bool equals(const char* cstr) const;
+    bool operator==(const String& rhs) const { return equals(rhs); }
+    bool operator==(const char* cstr) const { return equals(cstr); }
+    bool operator!=(const String& rhs) const { return !equals(rhs); }
+    bool operator!=(const char* cstr) const { return !equals(cstr); }
+    bool equalsIgnoreCase(const String& s) const;
+    bool startsWith(const String& prefix) const;
+    bool endsWith(const String& suffix) const;
+
+    char charAt(unsigned int index) const;
+    char operator[](unsigned int index) const { return charAt(index); }
+    int indexOf(char ch, unsigned int fromIndex = 0) const;
+    int indexOf(const String& str, unsigned int fromIndex = 0) const;
+    String substring(unsigned int beginIndex) const;
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    void trim();
+    void toLowerCase();
+    void toUpperCase();
+    long toInt() const;
+    float toFloat() const;
+
+private:
+    char*        _buf;
+    unsigned int _len;
+    unsigned int _cap;
+
+    void invalidate();
+    bool grow(unsigned int size);
+    String& copy(const char* cstr, unsigned int length);
+};
+
+// Конкатенация как у StringSumHelper: "a" + String(x), String + число и т.п.
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+String operator+(const String& lhs, int rhs);
+String operator+(const String& lhs, unsigned int rhs);
+String operator+(const String& lhs, long rhs);
+String operator+(const String& lhs, unsigned long rhs);
+String operator+(const String& lhs, float rhs);
+String operator+(const String& lhs, double rhs);
+String operator+(String&& lhs, const String& rhs);
+String operator+(String&& lhs, const char* rhs);
+
+#endif // SIM_WSTRING_H
@@ -0,0 +1,331 @@
+#include "WebServer.h"
+#include "sim.h"
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <string>
+#include <stdio.h>
+
+namespace sim {
+
+struct PendingRequest {
+    std::string uri;
+    std::string headers;
+};
+
+static std::deque<PendingRequest> s_queue;
+static HttpResponse               s_last;
+static HttpRouteStats             s_routes[24];
+static size_t                     s_routeCount = 0;
+static bool                       s_browserCache = false;
+static std::map<std::string, std::string> s_etags;   // URI → последний ETag
+
+void httpBrowserCache(bool enabled) {
+    HeapPause pause;
+    s_browserCache = enabled;
+    s_etags.clear();
+}
+
+// "Name: value\r\n..." → value или ""
+static std::string headerValue(const String& headers, const char* name) {
+    std::string hs(headers.c_str()), key = std::string(name) + ": ";
+    size_t p = hs.find(key);
+    if (p == std::string::npos) return std::string();
+    p += key.size();
+    return hs.substr(p, hs.find("\r\n", p) - p);
+}
+
+void httpGet(const char* uri, const char* headers) {
+    HeapPause pause;
+    s_queue.push_back({ uri ? uri : "/", headers ? headers : "" });
+}
+
+size_t httpPending() { return s_queue.size(); }
+
+const HttpResponse& httpLastResponse() { return s_last; }
+
+const HttpRouteStats* httpRoutes(size_t* count) {
+    if (count) *count = s_routeCount;
+    return s_routes;
+}
+
+static HttpRouteStats& routeStats(const char* path) {
+    for (size_t i = 0; i < s_routeCount; i++)
+        if (strcmp(s_routes[i].path, path) == 0) return s_routes[i];
+    if (s_routeCount < sizeof(s_routes) / sizeof(s_routes[0])) {
+        HttpRouteStats& r = s_routes[s_routeCount++];
+        snprintf(r.path, sizeof(r.path), "%s", path);
+        return r;
+    }
+    return s_routes[s_routeCount - 1];
+}
+
+} // namespace sim
+
+WebServer::WebServer(int port) : _port(port) {}
+WebServer::~WebServer() {}
+
+void WebServer::begin() {}
+
+void WebServer::on(const String& uri, THandlerFunction handler) {
+    on(uri, HTTP_ANY, handler);
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction fn) {
+    if (_routeCount >= MAX_ROUTES) return;
+    _routes[_routeCount++] = { uri, method, fn };
+}
+
+void WebServer::onNotFound(THandlerFunction fn) {
+    _notFound = fn;
+}
+
+void WebServer::collectHeaders(const char* headerKeys[], const size_t headerKeysCount) {
+    _collectedCount = 0;
+    for (size_t i = 0; i < headerKeysCount && _collectedCount < MAX_HEADERS; i++) {
+        _collected[_collectedCount++] = headerKeys[i];
+    }
+}
+
+String WebServer::arg(const String& name) const {
+    for (int i = 0; i < _argCount; i++)
+        if (_argNames[i] == name) return _argValues[i];
+    return String();
+}
+
+bool WebServer::hasArg(const String& name) const {
+    for (int i = 0; i < _argCount; i++)
+        if (_argNames[i] == name) return true;
+    return false;
+}
+
+String WebServer::header(const String& name) const {
+    for (int i = 0; i < _collectedCount; i++)
+        if (_collected[i].equalsIgnoreCase(name)) return _collectedValues[i];
+    return String();
+}
+
+bool WebServer::hasHeader(const String& name) const {
+    for (int i = 0; i < _collectedCount; i++)
+        if (_collected[i].equalsIgnoreCase(name)) return _collectedValues[i].length() > 0;
+    return false;
+}
+
+// Разбор "path?a=1&b=2" и "Name: value\n..." — как парсер настоящего
+// WebServer, со всеми его выделениями String
+void WebServer::parseRequest(const char* uri, const char* headers) {
+    String full(uri);
+    int q = full.indexOf('?');
+    _currentUri    = q >= 0 ? full.substring(0, q) : full;
+    _currentMethod = HTTP_GET;
+    _argCount      = 0;
+
+    if (q >= 0) {
+        String query = full.substring(q + 1);
+        unsigned int pos = 0;
+        while (pos < query.length() && _argCount < MAX_ARGS) {
+            int amp = query.indexOf('&', pos);
+            unsigned int end = amp >= 0 ? (unsigned int)amp : query.length();
+            String pair = query.substring(pos, end);
+            int eq = pair.indexOf('=');
+            _argNames[_argCount]  = eq >= 0 ? pair.substring(0, eq) : pair;
+            _argValues[_argCount] = eq >= 0 ? pair.substring(eq + 1) : String();
+            _argCount++;
+            pos = end + 1;
+        }
+    }
+
+    for (int i = 0; i < _collectedCount; i++) _collectedValues[i] = String();
+    String hs(headers);
+    unsigned int pos = 0;
+    while (pos < hs.length()) {
+        int nl = hs.indexOf('\n', pos);
+        unsigned int end = nl >= 0 ? (unsigned int)nl : hs.length();
+        String line = hs.substring(pos, end);
+        int colon = line.indexOf(':');
+        if (colon > 0) {
+            String name  = line.substring(0, colon);
+            String value = line.substring(colon + 1);
+            value.trim();
+            for (int i = 0; i < _collectedCount; i++)
+                if (_collected[i].equalsIgnoreCase(name)) _collectedValues[i] = value;
+        }
+        pos = end + 1;
+    }
+}
+
+void WebServer::handleClient() {
+    if (sim::s_queue.empty()) return;
+    // Без WiFi клиенты до нас не доберутся — запросы ждут подключения
+    // (как события WebSocketsServer), а не теряются
+    if (WiFi.status() != WL_CONNECTED) return;
+
+    sim::PendingRequest req;
+    {
+        sim::HeapPause pause;
+        req = sim::s_queue.front();
+        sim::s_queue.pop_front();
+        if (sim::s_browserCache && req.headers.find("If-None-Match") == std::string::npos) {
+            auto it = sim::s_etags.find(req.uri);
+            if (it != sim::s_etags.end()) req.headers += "If-None-Match: " + it->second + "\n";
+        }
+    }
+
+    {
+        sim::HeapPause pause;
+        sim::s_last = sim::HttpResponse();
+    }
+
+    uint64_t allocs0 = sim::heap().allocs;
+    size_t   live0   = sim::heap().live;
+    uint64_t virt0   = sim::nowUs();
+    sim::resetHeapWindow();
+    auto     host0   = std::chrono::steady_clock::now();
+
+    parseRequest(req.uri.c_str(), req.headers.c_str());
+
+    bool handled = false;
+    for (int i = 0; i < _routeCount; i++) {
+        const Route& r = _routes[i];
+        if ((r.method == HTTP_ANY || r.method == _currentMethod) && r.uri == _currentUri) {
+            r.fn();
+            handled = true;
+            break;
+        }
+    }
+    if (!handled) {
+        if (_notFound) _notFound();
+        else send(404, "text/plain", "Not found");
+    }
+
+    auto     host1 = std::chrono::steady_clock::now();
+    uint64_t ns    = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(host1 - host0).count();
+
+    sim::HttpRouteStats& st = sim::routeStats(handled ? _currentUri.c_str() : "(404)");
+    st.requests++;
+    st.hostNs    += ns;
+    if (ns > st.maxHostNs) st.maxHostNs = ns;
+    st.virtualUs += sim::nowUs() - virt0;
+    st.allocs    += sim::heap().allocs - allocs0;
+    st.wireBytes += sim::s_last.wireBytes;
+    size_t growth = sim::heap().windowPeak > live0 ? sim::heap().windowPeak - live0 : 0;
+    if (growth > st.peakHeap) st.peakHeap = growth;
+
+    if (sim::s_browserCache && sim::s_last.code == 200) {
+        sim::HeapPause pause;
+        std::string etag = sim::headerValue(sim::s_last.headers, "ETag");
+        if (!etag.empty()) sim::s_etags[req.uri] = etag;
+    }
+
+    _responseHeaders = String();
+    _contentLength   = CONTENT_LENGTH_NOT_SET;
+    _chunked         = false;
+}
+
+// --------------------------------------------
+// Отправка
+// --------------------------------------------
+void WebServer::transmit(const char* data, size_t len) {
+    (void)data;   // Содержимое не нужно — только объём
+    uint32_t rate = sim::wifi().txBytesPerMs ? sim::wifi().txBytesPerMs : 1;
+    sim::advanceUs((uint64_t)len * 1000ULL / rate);
+
+    sim::HeapPause pause;
+    sim::s_last.wireBytes += len;
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+    String line = name + ": " + value + "\r\n";
+    if (first) _responseHeaders = line + _responseHeaders;
+    else       _responseHeaders += line;
+}
+
+void WebServer::writeHead(int code, const char* contentType, size_t length) {
+    // setContentLength() до send*() важнее длины тела — как _prepareHeader()
+    // настоящего WebServer: заголовок с объявленной длиной или chunked
+    if (_contentLength != CONTENT_LENGTH_NOT_SET) length = _contentLength;
+
+    String head = "HTTP/1.1 " + String(code) + " \r\n";
+    if (contentType) {
+        head += "Content-Type: ";
+        head += contentType;
+        head += "\r\n";
+    }
+    if (length == CONTENT_LENGTH_UNKNOWN) {
+        head += "Transfer-Encoding: chunked\r\n";
+        _chunked = true;
+    } else {
+        head += "Content-Length: " + String((unsigned long)length) + "\r\n";
+    }
+    head += _responseHeaders;
+    head += "Connection: close\r\n\r\n";
+    transmit(head.c_str(), head.length());
+
+    sim::HeapPause pause;
+    sim::s_last.code        = code;
+    sim::s_last.contentType = contentType ? contentType : "";
+    sim::s_last.chunked     = _chunked;
+    sim::s_last.headers     = _responseHeaders;
+}
+
+void WebServer::send(int code, const char* content_type, const String& content) {
+    writeHead(code, content_type, content.length());
+    if (_chunked) {
+        if (content.length()) sendContent(content);
+        return;
+    }
+    transmit(content.c_str(), content.length());
+    sim::HeapPause pause;
+    sim::s_last.body = content;
+}
+
+void WebServer::send(int code, const String& content_type, const String& content) {
+    send(code, content_type.c_str(), content);
+}
+
+void WebServer::send(int code, const char* content_type, const char* content) {
+    send_P(code, content_type, content);
+}
+
+void WebServer::send_P(int code, PGM_P content_type, PGM_P content) {
+    send_P(code, content_type, content, content ? strlen(content) : 0);
+}
+
+void WebServer::send_P(int code, PGM_P content_type, PGM_P content, size_t contentLength) {
+    writeHead(code, content_type, contentLength);
+    if (_chunked) {
+        if (contentLength) sendContent(content, contentLength);
+        return;
+    }
+    transmit(content, contentLength);
+    sim::HeapPause pause;
+    sim::s_last.body = String(content, (unsigned int)contentLength);
+}
+
+void WebServer::sendContent(const String& content) {
+    sendContent(content.c_str(), content.length());
+}
+
+void WebServer::sendContent(const char* content, size_t contentLength) {
+    if (_chunked) {
+        char prefix[12];
+        int  n = snprintf(prefix, sizeof(prefix), "%zx\r\n", contentLength);
+        transmit(prefix, (size_t)n);
+        transmit(content, contentLength);
+        transmit("\r\n", 2);
+        if (contentLength == 0) _chunked = false;   // Завершающий нулевой чанк
+    } else {
+        transmit(content, contentLength);
+    }
+    sim::HeapPause pause;
+    sim::s_last.body.concat(content, (unsigned int)contentLength);
+}
+
+void WebServer::sendContent_P(PGM_P content) {
+    sendContent(content, strlen(content));
+}
+
+void WebServer::sendContent_P(PGM_P content, size_t size) {
+    sendContent(content, size);
+}
@@ -0,0 +1,144 @@
+#ifndef SIM_WEBSERVER_H
+#define SIM_WEBSERVER_H
+
+// WebServer (Arduino-ESP32) для хост-сборки. Запросы в него кладёт стенд
+// (sim::httpGet), handleClient() обрабатывает не больше одного за вызов —
+// как и настоящий синхронный сервер. Отправка тела сдвигает виртуальные
+// часы по пропускной способности sim::wifi().txBytesPerMs.
+
+#include <Arduino.h>
+#include <functional>
+#include "WiFi.h"
+
+typedef enum {
+    HTTP_DELETE = 0,
+    HTTP_GET    = 1,
+    HTTP_HEAD   = 2,
+    HTTP_POST   = 3,
+    HTTP_PUT    = 4,
+    HTTP_OPTIONS = 6,
+    HTTP_PATCH  = 28,
+    HTTP_ANY    = 255,
+} HTTPMethod;
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+class WiFiClient {
+public:
+    void flush() {}
+    void stop() {}
+    bool connected() const { return true; }
+    IPAddress remoteIP() const { return IPAddress(192, 168, 1, 50); }
+};
+
+namespace sim {
+
+// Ответ, как его увидел бы клиент
+struct HttpResponse {
+    int         code = 0;
+    String      contentType;
+    String      body;            // Для чанкованного — склеенные чанки
+    String      headers;         // "Name: value\n" построчно
+    bool        chunked = false;
+    size_t      wireBytes = 0;   // Сколько байт ушло в сокет (заголовки + тело)
+};
+
+// Статистика по маршруту
+struct HttpRouteStats {
+    char     path[32]   = {};
+    uint64_t requests   = 0;
+    uint64_t hostNs     = 0;     // Реальное время хоста в обработчике
+    uint64_t maxHostNs  = 0;
+    uint64_t virtualUs  = 0;     // Виртуальное (отправка по сети и т.п.)
+    uint64_t allocs     = 0;     // Выделений кучи внутри обработчика
+    uint64_t wireBytes  = 0;
+    size_t   peakHeap   = 0;     // Пик прироста кучи за один запрос
+};
+
+// Поставить GET-запрос в очередь. headers — "Name: value\n..." или nullptr
+void httpGet(const char* uri, const char* headers = nullptr);
+size_t httpPending();
+const HttpResponse& httpLastResponse();
+const HttpRouteStats* httpRoutes(size_t* count);
+
+// Клиенты ведут себя как браузер с HTTP-кэшем: запоминают ETag ответа 200
+// и шлют его в If-None-Match при следующем запросе того же URI
+void httpBrowserCache(bool enabled);
+
+} // namespace sim
+
+class WebServer {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    explicit WebServer(int port = 80);
+    ~WebServer();
+
+    void begin();
+    void handleClient();
+
+    void on(const String& uri, THandlerFunction handler);
+    void on(const String& uri, HTTPMethod method, THandlerFunction fn);
+    void onNotFound(THandlerFunction fn);
+
+    String     uri() const { return _currentUri; }
+    HTTPMethod method() const { return _currentMethod; }
+    String     arg(const String& name) const;
+    bool       hasArg(const String& name) const;
+    int        args() const { return _argCount; }
+    String     header(const String& name) const;
+    bool       hasHeader(const String& name) const;
+    void       collectHeaders(const char* headerKeys[], const size_t headerKeysCount);
+
+    void send(int code, const char* content_type = nullptr, const String& content = String(""));
+    void send(int code, const String& content_type, const String& content);
+    void send(int code, const char* content_type, const char* content);
+    void send_P(int code, PGM_P content_type, PGM_P content);
+    void send_P(int code, PGM_P content_type, PGM_P content, size_t contentLength);
+
+    void setContentLength(size_t contentLength) { _contentLength = contentLength; }
+    void sendHeader(const String& name, const String& value, bool first = false);
+    void sendContent(const String& content);
+    void sendContent(const char* content, size_t contentLength);
+    void sendContent_P(PGM_P content);
+    void sendContent_P(PGM_P content, size_t size);
+
+    WiFiClient& client() { return _client; }
+
+private:
+    static constexpr int MAX_ROUTES  = 16;
+    static constexpr int MAX_ARGS    = 8;
+    static constexpr int MAX_HEADERS = 8;
+
+    struct Route {
+        String           uri;
+        HTTPMethod       method;
+        THandlerFunction fn;
+    };
+
+    int              _port;
+    Route            _routes[MAX_ROUTES];
+    int              _routeCount = 0;
+    THandlerFunction _notFound;
+    WiFiClient       _client;
+
+    String     _currentUri;
+    HTTPMethod _currentMethod = HTTP_GET;
+    String     _argNames[MAX_ARGS];
+    String     _argValues[MAX_ARGS];
+    int        _argCount = 0;
+    String     _collected[MAX_HEADERS];
+    String     _collectedValues[MAX_HEADERS];
+    int        _collectedCount = 0;
+
+    String _responseHeaders;
+    size_t _contentLength = CONTENT_LENGTH_NOT_SET;
+    bool   _chunked = false;
+
+    void   parseRequest(const char* uri, const char* headers);
+    void   writeHead(int code, const char* contentType, size_t length);
+    void   transmit(const char* data, size_t len);
+};
+
+#endif // SIM_WEBSERVER_H
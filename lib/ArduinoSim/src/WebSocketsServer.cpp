@@ -0,0 +1,158 @@
+#include "WebSocketsServer.h"
+#include "WiFi.h"
+#include "sim.h"
+
+#include <deque>
+#include <string>
+
+// Сколько библиотека ждёт, пока TCP примет кадр медленного клиента
+static constexpr uint64_t WS_STALL_TIMEOUT_US = 5000;
+
+namespace sim {
+
+struct WsEvent {
+    int      num;
+    WStype_t type;
+};
+
+static WsStats             s_stats;
+static std::deque<WsEvent> s_events;
+static bool                s_slots[WEBSOCKETS_SERVER_CLIENT_MAX];
+static std::string         s_lastText[WEBSOCKETS_SERVER_CLIENT_MAX];
+static bool                s_stalled[WEBSOCKETS_SERVER_CLIENT_MAX];
+
+const WsStats& wsStats() { return s_stats; }
+
+int wsConnect() {
+    HeapPause pause;
+    for (int i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+        if (!s_slots[i]) {
+            s_slots[i] = true;
+            s_events.push_back({ i, WStype_CONNECTED });
+            return i;
+        }
+    }
+    return -1;
+}
+
+void wsDisconnect(int num) {
+    HeapPause pause;
+    if (num < 0 || num >= WEBSOCKETS_SERVER_CLIENT_MAX || !s_slots[num]) return;
+    s_slots[num] = false;
+    s_events.push_back({ num, WStype_DISCONNECTED });
+}
+
+int wsClientCount() {
+    int n = 0;
+    for (bool s : s_slots) n += s ? 1 : 0;
+    return n;
+}
+
+const char* wsLastText(int num) {
+    if (num < 0 || num >= WEBSOCKETS_SERVER_CLIENT_MAX) return "";
+    return s_lastText[num].c_str();
+}
+
+void wsStall(int num, bool stalled) {
+    if (num >= 0 && num < WEBSOCKETS_SERVER_CLIENT_MAX) s_stalled[num] = stalled;
+}
+
+} // namespace sim
+
+WebSocketsServer::WebSocketsServer(uint16_t port, const String&, const String&)
+    : _port(port) {}
+
+WebSocketsServer::~WebSocketsServer() {}
+
+void WebSocketsServer::begin()  { _running = true; }
+void WebSocketsServer::close()  { _running = false; }
+
+void WebSocketsServer::loop() {
+    if (!_running) return;
+    // Без WiFi клиенты до нас не доберутся — события ждут подключения
+    if (WiFi.status() != WL_CONNECTED) return;
+    while (!sim::s_events.empty()) {
+        sim::WsEvent ev;
+        {
+            sim::HeapPause pause;
+            ev = sim::s_events.front();
+            sim::s_events.pop_front();
+        }
+        if (ev.type == WStype_CONNECTED)    _connected[ev.num] = true;
+        if (ev.type == WStype_DISCONNECTED) _connected[ev.num] = false;
+        if (_cbEvent) _cbEvent((uint8_t)ev.num, ev.type, nullptr, 0);
+    }
+}
+
+bool WebSocketsServer::deliver(uint8_t num, const uint8_t* payload, size_t length) {
+    if (num >= WEBSOCKETS_SERVER_CLIENT_MAX || !_connected[num]) return false;
+    if (WiFi.status() != WL_CONNECTED) return false;
+    if (sim::s_stalled[num]) {
+        // Таймаут записи: loop() простоял, кадр не ушёл
+        sim::advanceUs(WS_STALL_TIMEOUT_US);
+        return false;
+    }
+
+    // Заголовок кадра 2-4 байта + полезная нагрузка
+    size_t   frame = length + (length < 126 ? 2 : 4);
+    uint32_t rate  = sim::wifi().txBytesPerMs ? sim::wifi().txBytesPerMs : 1;
+    sim::advanceUs((uint64_t)frame * 1000ULL / rate + 50);
+
+    sim::s_stats.frames++;
+    sim::s_stats.bytes += frame;
+    sim::HeapPause pause;
+    sim::s_lastText[num].assign(reinterpret_cast<const char*>(payload), length);
+    return true;
+}
+
+bool WebSocketsServer::sendTXT(uint8_t num, const uint8_t* payload, size_t length, bool) {
+    if (length == 0) length = strlen(reinterpret_cast<const char*>(payload));
+    sim::s_stats.messages++;
+    return deliver(num, payload, length);
+}
+
+bool WebSocketsServer::sendTXT(uint8_t num, const char* payload, size_t length, bool h) {
+    return sendTXT(num, reinterpret_cast<const uint8_t*>(payload), length, h);
+}
+
+bool WebSocketsServer::sendTXT(uint8_t num, String& payload) {
+    return sendTXT(num, payload.c_str(), payload.length());
+}
+
+bool WebSocketsServer::broadcastTXT(const uint8_t* payload, size_t length, bool) {
+    if (length == 0) length = strlen(reinterpret_cast<const char*>(payload));
+    sim::s_stats.messages++;
+    bool ok = true;
+    for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++)
+        if (_connected[i]) ok = deliver(i, payload, length) && ok;
+    return ok;
+}
+
+bool WebSocketsServer::broadcastTXT(const char* payload, size_t length, bool h) {
+    return broadcastTXT(reinterpret_cast<const uint8_t*>(payload), length, h);
+}
+
+bool WebSocketsServer::broadcastTXT(String& payload) {
+    return broadcastTXT(payload.c_str(), payload.length());
+}
+
+void WebSocketsServer::disconnect(uint8_t num) {
+    if (num < WEBSOCKETS_SERVER_CLIENT_MAX && _connected[num]) {
+        _connected[num] = false;
+        sim::wsDisconnect(num);
+    }
+}
+
+uint8_t WebSocketsServer::connectedClients(bool) {
+    uint8_t n = 0;
+    for (bool c : _connected) n += c ? 1 : 0;
+    return n;
+}
+
+bool WebSocketsServer::clientIsConnected(uint8_t num) {
+    return num < WEBSOCKETS_SERVER_CLIENT_MAX && _connected[num];
+}
+
+IPAddress WebSocketsServer::remoteIP(uint8_t num) {
+    return IPAddress(192, 168, 1, (uint8_t)(50 + num));
+}
@@ -0,0 +1,86 @@
+#ifndef SIM_WEBSOCKETSSERVER_H
+#define SIM_WEBSOCKETSSERVER_H
+
+// WebSocketsServer (links2004) для хост-сборки. Клиенты подключаются
+// через sim::wsConnect(); события доставляются из loop(), как в библиотеке.
+// Каждый кадр стоит виртуального времени по пропускной способности WiFi.
+
+#include <Arduino.h>
+#include <functional>
+#include "IPAddress.h"
+
+#ifndef WEBSOCKETS_SERVER_CLIENT_MAX
+#define WEBSOCKETS_SERVER_CLIENT_MAX 4
+#endif
+
+typedef enum {
+    WStype_ERROR,
+    WStype_DISCONNECTED,
+    WStype_CONNECTED,
+    WStype_TEXT,
+    WStype_BIN,
+    WStype_FRAGMENT_TEXT_START,
+    WStype_FRAGMENT_BIN_START,
+    WStype_FRAGMENT,
+    WStype_FRAGMENT_FIN,
+    WStype_PING,
+    WStype_PONG,
+} WStype_t;
+
+namespace sim {
+
+struct WsStats {
+    uint64_t frames   = 0;   // Кадров, ушедших клиентам (по одному на клиента)
+    uint64_t bytes    = 0;
+    uint64_t messages = 0;   // Вызовов sendTXT/broadcastTXT
+};
+const WsStats& wsStats();
+
+// Подключить/отключить виртуального клиента (событие придёт в loop())
+int  wsConnect();
+void wsDisconnect(int num);
+int  wsClientCount();
+// Сколько байт последним получил клиент num (для проверки содержимого)
+const char* wsLastText(int num);
+// "Медленный" клиент: пока stalled, sendTXT ему возвращает false —
+// как библиотека, у которой запись в TCP упёрлась в таймаут
+void wsStall(int num, bool stalled);
+
+} // namespace sim
+
+class WebSocketsServer {
+public:
+    typedef std::function<void(uint8_t num, WStype_t type, uint8_t* payload, size_t length)>
+        WebSocketServerEvent;
+
+    explicit WebSocketsServer(uint16_t port, const String& origin = "", const String& protocol = "arduino");
+    ~WebSocketsServer();
+
+    void begin();
+    void close();
+    void loop();
+    void onEvent(WebSocketServerEvent cbEvent) { _cbEvent = cbEvent; }
+
+    bool sendTXT(uint8_t num, const uint8_t* payload, size_t length = 0, bool headerToPayload = false);
+    bool sendTXT(uint8_t num, const char* payload, size_t length = 0, bool headerToPayload = false);
+    bool sendTXT(uint8_t num, String& payload);
+
+    bool broadcastTXT(const uint8_t* payload, size_t length = 0, bool headerToPayload = false);
+    bool broadcastTXT(const char* payload, size_t length = 0, bool headerToPayload = false);
+    bool broadcastTXT(String& payload);
+
+    void     disconnect(uint8_t num);
+    uint8_t  connectedClients(bool ping = false);
+    bool     clientIsConnected(uint8_t num);
+    IPAddress remoteIP(uint8_t num);
+
+private:
+    uint16_t             _port;
+    WebSocketServerEvent _cbEvent;
+    bool                 _running = false;
+    bool                 _connected[WEBSOCKETS_SERVER_CLIENT_MAX] = {};
+
+    bool deliver(uint8_t num, const uint8_t* payload, size_t length);
+};
+
+#endif // SIM_WEBSOCKETSSERVER_H
@@ -0,0 +1,153 @@
+#include "WiFi.h"
+#include "sim.h"
+#include <stdio.h>
+
+namespace sim {
+static WiFiModel s_wifi;
+WiFiModel& wifi() { return s_wifi; }
+} // namespace sim
+
+WiFiClass WiFi;
+
+String IPAddress::toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u",
+             (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(buf);
+}
+
+bool WiFiClass::mode(wifi_mode_t m) {
+    _mode = m;
+    if (m == WIFI_OFF) {
+        _connected = _connecting = false;
+    }
+    return true;
+}
+
+bool WiFiClass::setSleep(bool enable) {
+    _sleep = enable;
+    return true;
+}
+
+bool WiFiClass::disconnect(bool wifioff, bool) {
+    _connected = _connecting = false;
+    if (wifioff) _mode = WIFI_OFF;
+    return true;
+}
+
+int16_t WiFiClass::scanNetworks() {
+    // Блокирующий активный скан: все 13 каналов по ~170 мс
+    delay(sim::s_wifi.scanMs);
+    _scanCount = sim::s_wifi.linkUp ? 1 : 0;
+    return _scanCount;
+}
+
+String WiFiClass::SSID(uint8_t i) const {
+    return i < _scanCount ? String(sim::s_wifi.ssid) : String();
+}
+
+int32_t WiFiClass::RSSI(uint8_t i) const {
+    return i < _scanCount ? sim::s_wifi.rssi : 0;
+}
+
+int32_t WiFiClass::channel(uint8_t i) const {
+    return i < _scanCount ? sim::s_wifi.channel : 0;
+}
+
+uint8_t* WiFiClass::BSSID(uint8_t i) {
+    if (i >= _scanCount) return nullptr;
+    memcpy(_bssidBuf, sim::s_wifi.bssid, sizeof(_bssidBuf));
+    return _bssidBuf;
+}
+
+wifi_auth_mode_t WiFiClass::encryptionType(uint8_t) const {
+    return WIFI_AUTH_WPA2_PSK;
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char*, int32_t channel,
+                             const uint8_t* bssid, bool connect) {
+    if (_mode == WIFI_OFF) _mode = WIFI_STA;
+    snprintf(_targetSsid, sizeof(_targetSsid), "%s", ssid ? ssid : "");
+    _connected  = false;
+    _connecting = connect;
+
+    // С известными каналом и BSSID стек не сканирует эфир перед ассоциацией
+    bool fast = channel > 0 && bssid != nullptr &&
+                channel == sim::s_wifi.channel &&
+                memcmp(bssid, sim::s_wifi.bssid, 6) == 0;
+    // Канал задан, но AP уже не там — на нём её не найти
+    _wrongChannel = channel > 0 && channel != sim::s_wifi.channel;
+    uint32_t ms = fast ? sim::s_wifi.fastAssociateMs : sim::s_wifi.associateMs;
+    if (_staticIp && ms > sim::s_wifi.dhcpMs) ms -= sim::s_wifi.dhcpMs;
+    _connectAt = millis() + ms;
+    return WL_DISCONNECTED;
+}
+
+bool WiFiClass::reconnect() {
+    if (_mode == WIFI_OFF) return false;
+    _connected  = false;
+    _connecting = true;
+    _connectAt  = millis() + sim::s_wifi.fastAssociateMs;
+    return true;
+}
+
+wl_status_t WiFiClass::status() {
+    if (_connected && !sim::s_wifi.linkUp) {
+        _connected  = false;
+        _connecting = false;
+        return WL_CONNECTION_LOST;
+    }
+    if (_connecting && (long)(millis() - _connectAt) >= 0) {
+        if (sim::s_wifi.linkUp && !_wrongChannel && strcmp(_targetSsid, sim::s_wifi.ssid) == 0) {
+            _connecting = false;
+            _connected  = true;
+        } else {
+            // Ещё не видно AP — стек повторит попытку сам
+            _connectAt = millis() + sim::s_wifi.associateMs;
+        }
+    }
+    if (_connected) return WL_CONNECTED;
+    return _mode == WIFI_OFF ? WL_NO_SHIELD : WL_DISCONNECTED;
+}
+
+String WiFiClass::SSID() const {
+    return _connected ? String(sim::s_wifi.ssid) : String();
+}
+
+int8_t WiFiClass::RSSI() const {
+    return _connected ? (int8_t)sim::s_wifi.rssi : 0;
+}
+
+int32_t WiFiClass::channel() const {
+    return sim::s_wifi.channel;
+}
+
+uint8_t* WiFiClass::BSSID() {
+    memcpy(_bssidBuf, sim::s_wifi.bssid, sizeof(_bssidBuf));
+    return _bssidBuf;
+}
+
+String WiFiClass::BSSIDstr() const {
+    char buf[18];
+    const uint8_t* b = sim::s_wifi.bssid;
+    snprintf(buf, sizeof(buf), "%02X:%02X:%02X:%02X:%02X:%02X",
+             b[0], b[1], b[2], b[3], b[4], b[5]);
+    return String(buf);
+}
+
+IPAddress WiFiClass::localIP() const {
+    if (!_connected) return IPAddress();
+    return _staticIp ? IPAddress(_staticIp) : IPAddress(192, 168, 1, 100);
+}
+IPAddress WiFiClass::gatewayIP() const  { return _connected ? IPAddress(192, 168, 1, 1) : IPAddress(); }
+IPAddress WiFiClass::subnetMask() const { return _connected ? IPAddress(255, 255, 255, 0) : IPAddress(); }
+IPAddress WiFiClass::dnsIP(uint8_t) const { return _connected ? IPAddress(192, 168, 1, 1) : IPAddress(); }
+
+String WiFiClass::macAddress() const {
+    return String("34:85:18:00:00:01");
+}
+
+bool WiFiClass::config(IPAddress local, IPAddress, IPAddress, IPAddress, IPAddress) {
+    _staticIp = (uint32_t)local;
+    return true;
+}
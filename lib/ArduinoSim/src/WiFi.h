@@ -0,0 +1,108 @@
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+// WiFi STA для хост-сборки. Ассоциация и DHCP занимают виртуальное время
+// (sim::wifi().associateMs), скан блокирует на sim::wifi().scanMs —
+// как на железе. Обрыв связи моделируется через sim::wifi().linkUp.
+
+#include <Arduino.h>
+#include "IPAddress.h"
+
+typedef enum {
+    WL_NO_SHIELD       = 255,
+    WL_IDLE_STATUS     = 0,
+    WL_NO_SSID_AVAIL   = 1,
+    WL_SCAN_COMPLETED  = 2,
+    WL_CONNECTED       = 3,
+    WL_CONNECT_FAILED  = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED    = 6,
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF    = 0,
+    WIFI_STA    = 1,
+    WIFI_AP     = 2,
+    WIFI_AP_STA = 3,
+} wifi_mode_t;
+
+typedef enum {
+    WIFI_AUTH_OPEN = 0,
+    WIFI_AUTH_WEP,
+    WIFI_AUTH_WPA_PSK,
+    WIFI_AUTH_WPA2_PSK,
+    WIFI_AUTH_WPA_WPA2_PSK,
+} wifi_auth_mode_t;
+
+namespace sim {
+
+struct WiFiModel {
+    const char* ssid         = "SkyNet";   // Точка доступа "в эфире"
+    int         rssi         = -58;
+    int         channel      = 6;
+    uint8_t     bssid[6]     = { 0x24, 0x0A, 0xC4, 0x11, 0x22, 0x33 };
+    bool        linkUp       = true;       // false — AP пропала
+    uint32_t    scanMs       = 2200;       // Полный активный скан всех каналов
+    uint32_t    associateMs  = 1400;       // Auth + assoc + 4-way + DHCP
+    uint32_t    fastAssociateMs = 350;     // То же при известных канале и BSSID
+    uint32_t    dhcpMs       = 300;        // Из них DHCP — не нужен при WiFi.config()
+    uint32_t    txBytesPerMs = 250;        // Полезная скорость TCP (~250 КБ/с)
+};
+WiFiModel& wifi();
+
+} // namespace sim
+
+class WiFiClass {
+public:
+    bool mode(wifi_mode_t m);
+    wifi_mode_t getMode() const { return _mode; }
+    bool setSleep(bool enable);
+    bool getSleep() const { return _sleep; }
+    bool setAutoReconnect(bool enable) { _autoReconnect = enable; return true; }
+    void persistent(bool) {}
+    bool disconnect(bool wifioff = false, bool eraseap = false);
+
+    int16_t     scanNetworks();
+    String      SSID(uint8_t i) const;
+    int32_t     RSSI(uint8_t i) const;
+    int32_t     channel(uint8_t i) const;
+    uint8_t*    BSSID(uint8_t i);
+    wifi_auth_mode_t encryptionType(uint8_t i) const;
+    void        scanDelete() { _scanCount = 0; }
+
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr,
+                      int32_t channel = 0, const uint8_t* bssid = nullptr,
+                      bool connect = true);
+    bool        reconnect();
+    wl_status_t status();
+
+    String    SSID() const;
+    int8_t    RSSI() const;
+    int32_t   channel() const;
+    uint8_t*  BSSID();
+    String    BSSIDstr() const;
+    IPAddress localIP() const;
+    IPAddress gatewayIP() const;
+    IPAddress subnetMask() const;
+    IPAddress dnsIP(uint8_t i = 0) const;
+    String    macAddress() const;
+    bool      config(IPAddress local, IPAddress gateway, IPAddress subnet,
+                     IPAddress dns1 = IPAddress(), IPAddress dns2 = IPAddress());
+
+private:
+    wifi_mode_t _mode = WIFI_OFF;
+    bool        _sleep = true;
+    bool        _autoReconnect = true;
+    bool        _connecting = false;
+    bool        _connected  = false;
+    unsigned long _connectAt = 0;
+    int16_t     _scanCount = 0;
+    char        _targetSsid[33] = {};
+    uint8_t     _bssidBuf[6] = {};
+    uint32_t    _staticIp = 0;             // WiFi.config(): 0 — DHCP
+    bool        _wrongChannel = false;     // begin() с каналом, где AP нет
+};
+
+extern WiFiClass WiFi;
+
+#endif // SIM_WIFI_H
@@ -0,0 +1,84 @@
+#include "Wire.h"
+#include "sim.h"
+
+namespace sim {
+
+static I2CDevice* s_devices[128];
+static I2CStats   s_stats;
+
+void attachI2C(uint8_t address, I2CDevice* device) {
+    if (address < 128) s_devices[address] = device;
+}
+
+const I2CStats& i2cStats() { return s_stats; }
+
+static I2CDevice* deviceAt(uint8_t address) {
+    I2CDevice* d = address < 128 ? s_devices[address] : nullptr;
+    return (d && d->present()) ? d : nullptr;
+}
+
+} // namespace sim
+
+TwoWire Wire;
+
+bool TwoWire::begin(int, int, uint32_t frequency) {
+    if (frequency) _clock = frequency;
+    return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+    _clock = frequency;
+    return true;
+}
+
+// Байт = 8 бит + ACK; плюс START/адрес/STOP
+void TwoWire::chargeBus(size_t bytes) {
+    uint64_t us = ((bytes + 1) * 9ULL * 1000000ULL) / _clock + 10;
+    sim::advanceUs(us);
+    sim::s_stats.transactions++;
+    sim::s_stats.bytes  += bytes;
+    sim::s_stats.busyUs += us;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    _txAddr = address;
+    _txLen  = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (_txLen >= BUFFER_SIZE) return 0;
+    _tx[_txLen++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t len) {
+    size_t n = 0;
+    while (n < len && write(data[n])) n++;
+    return n;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+    chargeBus(_txLen);
+    sim::I2CDevice* dev = sim::deviceAt(_txAddr);
+    if (!dev) return 2;   // NACK на адресе
+    dev->onWrite(_tx, _txLen);
+    return 0;
+}
+
+size_t TwoWire::requestFrom(uint8_t address, size_t len, bool) {
+    if (len > BUFFER_SIZE) len = BUFFER_SIZE;
+    chargeBus(len);
+    _rxLen = _rxPos = 0;
+    sim::I2CDevice* dev = sim::deviceAt(address);
+    if (!dev) return 0;
+    _rxLen = dev->onRead(_rx, len);
+    return _rxLen;
+}
+
+int TwoWire::available() {
+    return (int)(_rxLen - _rxPos);
+}
+
+int TwoWire::read() {
+    return _rxPos < _rxLen ? _rx[_rxPos++] : -1;
+}
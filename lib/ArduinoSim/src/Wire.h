@@ -0,0 +1,66 @@
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+// I2C-мастер поверх моделей устройств (sim::I2CDevice). Каждая транзакция
+// сдвигает виртуальные часы на время передачи по шине при текущей частоте —
+// так кадр OLED или опрос AHT10 стоят в симуляции столько же, сколько на плате.
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace sim {
+
+class I2CDevice {
+public:
+    virtual ~I2CDevice() = default;
+    virtual bool   present() const { return true; }
+    virtual void   onWrite(const uint8_t* data, size_t len) { (void)data; (void)len; }
+    virtual size_t onRead(uint8_t* data, size_t len) { (void)data; (void)len; return 0; }
+};
+
+void attachI2C(uint8_t address, I2CDevice* device);
+
+// Накопленная статистика шины
+struct I2CStats {
+    uint64_t transactions = 0;
+    uint64_t bytes        = 0;
+    uint64_t busyUs       = 0;
+};
+const I2CStats& i2cStats();
+
+} // namespace sim
+
+class TwoWire {
+public:
+    bool     begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool     setClock(uint32_t frequency);
+    uint32_t getClock() const { return _clock; }
+
+    void    beginTransmission(uint8_t address);
+    void    beginTransmission(int address) { beginTransmission((uint8_t)address); }
+    size_t  write(uint8_t data);
+    size_t  write(const uint8_t* data, size_t len);
+    uint8_t endTransmission(bool sendStop = true);
+
+    size_t requestFrom(uint8_t address, size_t len, bool sendStop = true);
+    size_t requestFrom(int address, int len) { return requestFrom((uint8_t)address, (size_t)len); }
+    int    available();
+    int    read();
+
+private:
+    static constexpr size_t BUFFER_SIZE = 128;
+
+    uint32_t _clock   = 100000;
+    uint8_t  _txAddr  = 0;
+    uint8_t  _tx[BUFFER_SIZE];
+    size_t   _txLen   = 0;
+    uint8_t  _rx[BUFFER_SIZE];
+    size_t   _rxLen   = 0;
+    size_t   _rxPos   = 0;
+
+    void chargeBus(size_t bytes);
+};
+
+extern TwoWire Wire;
+
+#endif // SIM_WIRE_H
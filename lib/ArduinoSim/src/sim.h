@@ -0,0 +1,122 @@
+#ifndef SIM_H
+#define SIM_H
+
+// ============================================
+// Управление хост-симуляцией (env:native)
+// ============================================
+// Прошивка про этот заголовок ничего не знает — его используют только
+// стенды (sim_main.cpp) и сами заглушки Arduino/WiFi/WebServer/...
+//
+// Время виртуальное: millis()/micros() возвращают счётчик, который двигают
+// только delay(), явный sim::advanceUs() и модели периферии (преобразование
+// AHT10 ~80 мс, кадр OLED ~23 мс, замеры ADC и т.п.). Сам C++-код прошивки
+// на хосте выполняется "мгновенно", поэтому неделя работы проигрывается
+// за секунды, а все задержки в отчёте — это задержки, вызванные железом.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdexcept>
+
+namespace sim {
+
+// --------------------------------------------
+// Виртуальные часы
+// --------------------------------------------
+uint64_t nowUs();
+void     advanceUs(uint64_t us);
+void     advanceMs(uint64_t ms);
+
+// Время, проведённое в delay() — "честный" простой loop()
+uint64_t idleUs();
+
+// Сколько времени CPU провёл на частоте mhz (setCpuFrequencyMhz)
+uint64_t cpuClockUs(uint32_t mhz);
+uint64_t cpuClockSwitches();
+
+// --------------------------------------------
+// Учёт кучи (глобальные operator new/delete)
+// --------------------------------------------
+struct HeapStats {
+    uint64_t allocs    = 0;   // Всего выделений
+    uint64_t frees     = 0;   // Всего освобождений
+    uint64_t bytes     = 0;   // Всего выделено байт (суммарно)
+    size_t   live      = 0;   // Сейчас занято
+    size_t   peak      = 0;   // Пик занятого
+    size_t   windowPeak = 0;  // Пик с последнего resetHeapWindow()
+};
+const HeapStats& heap();
+void resetHeapWindow();
+
+// Учитываются только выделения, сделанные "прошивкой". Служебные
+// структуры стендов оборачиваются в HeapPause, чтобы не искажать счёт.
+class HeapPause {
+public:
+    HeapPause();
+    ~HeapPause();
+    HeapPause(const HeapPause&) = delete;
+    HeapPause& operator=(const HeapPause&) = delete;
+private:
+    bool _prev;
+};
+
+// --------------------------------------------
+// Модель окружающей среды (то, что "видит" AHT10)
+// --------------------------------------------
+struct Environment {
+    float baseTemp   = 22.0f;   // °C, среднесуточная
+    float tempSwing  = 3.0f;    // ± суточная амплитуда
+    float baseHumid  = 45.0f;   // %RH
+    float humidSwing = 10.0f;   // ± (в противофазе с температурой)
+    float noise      = 0.05f;   // Шум измерения
+    bool  sensorPresent = true;
+};
+Environment& environment();
+float ambientTemperature();
+float ambientHumidity();
+
+// --------------------------------------------
+// Модель питания (TP4056 + делитель на ADC)
+// --------------------------------------------
+struct Power {
+    bool  usb            = true;    // true = USB (STDBY=LOW), false = батарея
+    float batteryVoltage = 4.10f;   // Текущее напряжение банки
+    float drainVPerHour  = 0.0f;    // Скорость разряда на батарее
+    int   chrgPin        = -1;      // Назначаются стендом из config.h
+    int   stdbyPin       = -1;
+    int   adcPin         = -1;
+    float dividerRatio   = 2.0f;
+};
+Power& power();
+
+// --------------------------------------------
+// GPIO
+// --------------------------------------------
+// Входы с подтяжкой читаются по уровню подтяжки, пока их не "нажали"
+void setPinLevel(int pin, int level);
+void releasePin(int pin);
+
+// --------------------------------------------
+// Serial
+// --------------------------------------------
+void setSerialEcho(bool enabled);   // false — вывод прошивки глушится
+
+// --------------------------------------------
+// Причина пробуждения для esp_sleep_get_wakeup_cause()
+// --------------------------------------------
+void setWakeupCause(int cause);
+
+// --------------------------------------------
+// Переходы, которые на железе не возвращаются
+// --------------------------------------------
+struct DeepSleep : std::runtime_error {
+    explicit DeepSleep(uint64_t us)
+        : std::runtime_error("deep sleep"), durationUs(us) {}
+    uint64_t durationUs;
+};
+struct Restart : std::runtime_error {
+    Restart() : std::runtime_error("restart") {}
+};
+
+} // namespace sim
+
+#endif // SIM_H
@@ -0,0 +1,81 @@
+// Модели устройств на шине I2C платы: AHT10 (0x38) и SSD1306 (0x3C)
+#include "Wire.h"
+#include "sim.h"
+
+namespace sim {
+
+// ============================================
+// AHT10
+// ============================================
+// Протокол как в даташите: 0xAC 0x33 0x00 запускает преобразование,
+// бит 7 статуса (BUSY) держится ~75-80 мс, затем 6 байт: статус,
+// 20 бит влажности и 20 бит температуры.
+class Aht10Model : public I2CDevice {
+public:
+    static constexpr uint64_t CONVERSION_US = 80000;
+
+    bool present() const override { return environment().sensorPresent; }
+
+    void onWrite(const uint8_t* data, size_t len) override {
+        if (len == 0) return;
+        switch (data[0]) {
+            case 0xBA: _calibrated = false; break;
+            case 0xE1: _calibrated = true;  break;
+            case 0xAC:
+                _readyAt = nowUs() + CONVERSION_US;
+                _pending = true;
+                break;
+            default: break;
+        }
+    }
+
+    size_t onRead(uint8_t* data, size_t len) override {
+        bool busy = _pending && nowUs() < _readyAt;
+        if (_pending && !busy) {
+            // Преобразование закончилось — фиксируем измеренные значения
+            _pending = false;
+            float t = ambientTemperature();
+            float h = ambientHumidity();
+            _rawT = (uint32_t)((t + 50.0f) / 200.0f * 0x100000);
+            _rawH = (uint32_t)(h / 100.0f * 0x100000);
+            if (_rawT > 0xFFFFF) _rawT = 0xFFFFF;
+            if (_rawH > 0xFFFFF) _rawH = 0xFFFFF;
+        }
+        uint8_t frame[6] = {
+            (uint8_t)((busy ? 0x80 : 0x00) | (_calibrated ? 0x08 : 0x00)),
+            (uint8_t)(_rawH >> 12),
+            (uint8_t)(_rawH >> 4),
+            (uint8_t)(((_rawH & 0x0F) << 4) | ((_rawT >> 16) & 0x0F)),
+            (uint8_t)(_rawT >> 8),
+            (uint8_t)(_rawT),
+        };
+        size_t n = len < sizeof(frame) ? len : sizeof(frame);
+        for (size_t i = 0; i < n; i++) data[i] = frame[i];
+        return n;
+    }
+
+private:
+    bool     _calibrated = false;
+    bool     _pending    = false;
+    uint64_t _readyAt    = 0;
+    uint32_t _rawT       = 0;
+    uint32_t _rawH       = 0;
+};
+
+// ============================================
+// SSD1306 — просто принимает байты (время считает шина)
+// ============================================
+class Ssd1306Model : public I2CDevice {};
+
+static Aht10Model   s_aht10;
+static Ssd1306Model s_ssd1306;
+
+struct BoardInit {
+    BoardInit() {
+        attachI2C(0x38, &s_aht10);
+        attachI2C(0x3C, &s_ssd1306);
+    }
+};
+static BoardInit s_boardInit;
+
+} // namespace sim
@@ -0,0 +1,307 @@
+// Ядро хост-симуляции: виртуальные часы, учёт кучи, GPIO/ADC, Serial, ESP
+#include "Arduino.h"
+#include "sim.h"
+#include "esp_system.h"
+
+#include <stdio.h>
+#include <new>
+
+namespace sim {
+
+// ============================================
+// Виртуальные часы
+// ============================================
+static uint64_t s_nowUs  = 0;
+static uint64_t s_idleUs = 0;
+
+uint64_t nowUs()              { return s_nowUs; }
+void     advanceUs(uint64_t us) { s_nowUs += us; }
+void     advanceMs(uint64_t ms) { s_nowUs += ms * 1000ULL; }
+uint64_t idleUs()             { return s_idleUs; }
+
+// ============================================
+// Модели
+// ============================================
+static Environment s_env;
+static Power       s_power;
+
+Environment& environment() { return s_env; }
+Power&       power()       { return s_power; }
+
+// Детерминированный шум: прогон с теми же параметрами даёт те же цифры
+static uint32_t s_rng = 0x12345678u;
+static float noise() {
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return ((float)(s_rng >> 8) / (float)(1u << 24)) * 2.0f - 1.0f;
+}
+
+static float dayPhase() {
+    const double day = 86400.0e6;
+    return (float)(2.0 * M_PI * fmod((double)s_nowUs, day) / day);
+}
+
+float ambientTemperature() {
+    return s_env.baseTemp + s_env.tempSwing * sinf(dayPhase()) + s_env.noise * noise();
+}
+
+float ambientHumidity() {
+    float h = s_env.baseHumid - s_env.humidSwing * sinf(dayPhase()) + s_env.noise * noise();
+    return h < 0 ? 0 : (h > 100 ? 100 : h);
+}
+
+// ============================================
+// GPIO
+// ============================================
+static constexpr int PIN_COUNT = 32;
+static uint8_t s_pinMode[PIN_COUNT];
+static int8_t  s_pinForced[PIN_COUNT] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+static uint8_t s_pinOut[PIN_COUNT];
+
+void setPinLevel(int pin, int level) {
+    if (pin >= 0 && pin < PIN_COUNT) s_pinForced[pin] = level ? HIGH : LOW;
+}
+
+void releasePin(int pin) {
+    if (pin >= 0 && pin < PIN_COUNT) s_pinForced[pin] = -1;
+}
+
+static int readPin(int pin) {
+    if (pin < 0 || pin >= PIN_COUNT) return LOW;
+
+    // Выходы TP4056 — открытый коллектор: LOW = активен
+    if (pin == s_power.chrgPin || pin == s_power.stdbyPin) {
+        if (!s_power.usb) return HIGH;                      // DISCHARGING
+        return pin == s_power.stdbyPin ? LOW : HIGH;        // CHARGED
+    }
+    if (s_pinForced[pin] >= 0) return s_pinForced[pin];
+    if (s_pinMode[pin] == OUTPUT) return s_pinOut[pin];
+    return (s_pinMode[pin] & PULLUP) ? HIGH : LOW;
+}
+
+// ============================================
+// Куча
+// ============================================
+static HeapStats s_heap;
+static bool      s_heapTracking = true;
+
+const HeapStats& heap() { return s_heap; }
+
+void resetHeapWindow() { s_heap.windowPeak = s_heap.live; }
+
+HeapPause::HeapPause() : _prev(s_heapTracking) { s_heapTracking = false; }
+HeapPause::~HeapPause() { s_heapTracking = _prev; }
+
+// Заголовок перед каждым блоком: размер + признак "посчитан"
+struct alignas(16) BlockHeader {
+    size_t size;
+    bool   tracked;
+};
+
+static void* heapAlloc(size_t size) {
+    BlockHeader* h = static_cast<BlockHeader*>(malloc(sizeof(BlockHeader) + size));
+    if (!h) throw std::bad_alloc();
+    h->size    = size;
+    h->tracked = s_heapTracking;
+    if (h->tracked) {
+        s_heap.allocs++;
+        s_heap.bytes += size;
+        s_heap.live  += size;
+        if (s_heap.live > s_heap.peak) s_heap.peak = s_heap.live;
+        if (s_heap.live > s_heap.windowPeak) s_heap.windowPeak = s_heap.live;
+    }
+    return h + 1;
+}
+
+static void heapFree(void* p) {
+    if (!p) return;
+    BlockHeader* h = static_cast<BlockHeader*>(p) - 1;
+    if (h->tracked) {
+        s_heap.frees++;
+        s_heap.live -= h->size;
+    }
+    free(h);
+}
+
+// ============================================
+// Serial
+// ============================================
+static bool s_serialEcho = true;
+
+void setSerialEcho(bool enabled) { s_serialEcho = enabled; }
+
+} // namespace sim
+
+// Глобальная замена new/delete — единственная точка учёта кучи
+void* operator new(size_t size)                             { return sim::heapAlloc(size); }
+void* operator new[](size_t size)                           { return sim::heapAlloc(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return sim::heapAlloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return sim::heapAlloc(size); } catch (...) { return nullptr; }
+}
+void operator delete(void* p) noexcept                      { sim::heapFree(p); }
+void operator delete[](void* p) noexcept                    { sim::heapFree(p); }
+void operator delete(void* p, size_t) noexcept              { sim::heapFree(p); }
+void operator delete[](void* p, size_t) noexcept            { sim::heapFree(p); }
+
+// ============================================
+// Arduino API
+// ============================================
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < sim::PIN_COUNT) sim::s_pinMode[pin] = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin < sim::PIN_COUNT) sim::s_pinOut[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+    return sim::readPin(pin);
+}
+
+void analogReadResolution(uint8_t) {}
+void analogSetPinAttenuation(uint8_t, adc_attenuation_t) {}
+
+uint32_t analogReadMilliVolts(uint8_t pin) {
+    // Одно преобразование SAR ADC ~ 20 мкс
+    sim::advanceUs(20);
+    if ((int)pin != sim::s_power.adcPin) return 0;
+    float v = sim::s_power.batteryVoltage / sim::s_power.dividerRatio;
+    return (uint32_t)(v * 1000.0f + 4.0f * sim::noise());
+}
+
+uint16_t analogRead(uint8_t pin) {
+    return (uint16_t)(analogReadMilliVolts(pin) * 4095u / 3100u);
+}
+
+unsigned long millis() { return (unsigned long)(sim::s_nowUs / 1000ULL); }
+unsigned long micros() { return (unsigned long)sim::s_nowUs; }
+
+void delay(uint32_t ms) {
+    sim::s_nowUs  += ms * 1000ULL;
+    sim::s_idleUs += ms * 1000ULL;
+}
+
+void delayMicroseconds(uint32_t us) {
+    // Активное ожидание — CPU занят, это НЕ простой
+    sim::s_nowUs += us;
+}
+
+void yield() {}
+
+float temperatureRead() {
+    return 38.0f + sim::noise();
+}
+
+// --------------------------------------------
+// Serial
+// --------------------------------------------
+HWCDC Serial;
+
+void HWCDC::begin(unsigned long) {}
+
+size_t HWCDC::write(uint8_t c) {
+    if (sim::s_serialEcho && c != '\r') fputc(c, stdout);
+    return 1;
+}
+
+size_t HWCDC::write(const uint8_t* buffer, size_t size) {
+    if (sim::s_serialEcho) {
+        for (size_t i = 0; i < size; i++)
+            if (buffer[i] != '\r') fputc(buffer[i], stdout);
+    }
+    return size;
+}
+
+// --------------------------------------------
+// ESP
+// --------------------------------------------
+EspClass ESP;
+
+// Куча C3 после старта WiFi/lwIP: ~320 КБ всего, ~70 КБ съедает стек
+static constexpr uint32_t SIM_HEAP_SIZE     = 320 * 1024;
+static constexpr uint32_t SIM_HEAP_RESERVED = 70 * 1024;
+static uint32_t s_minFreeHeap = SIM_HEAP_SIZE;
+
+uint32_t EspClass::getHeapSize() { return SIM_HEAP_SIZE; }
+
+uint32_t EspClass::getFreeHeap() {
+    size_t   used = SIM_HEAP_RESERVED + sim::s_heap.live;
+    uint32_t free = used >= SIM_HEAP_SIZE ? 0 : (uint32_t)(SIM_HEAP_SIZE - used);
+    if (free < s_minFreeHeap) s_minFreeHeap = free;
+    return free;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+    getFreeHeap();
+    // Пик учтённых выделений тоже опускает минимум, даже если его не видели
+    size_t   peakUsed = SIM_HEAP_RESERVED + sim::s_heap.peak;
+    uint32_t atPeak   = peakUsed >= SIM_HEAP_SIZE ? 0 : (uint32_t)(SIM_HEAP_SIZE - peakUsed);
+    return atPeak < s_minFreeHeap ? atPeak : s_minFreeHeap;
+}
+
+uint32_t EspClass::getMaxAllocHeap() { return getFreeHeap() / 2; }
+
+uint32_t EspClass::getCpuFreqMHz() { return getCpuFrequencyMhz(); }
+
+// --------------------------------------------
+// Частота CPU: только учёт времени на каждой. Код прошивки на хосте
+// и так выполняется "мгновенно", а задержки периферии от частоты CPU
+// не зависят (I2C и ADC тактуются от APB)
+// --------------------------------------------
+namespace sim {
+static const uint32_t s_cpuLevels[] = { 160, 80, 40, 20, 10 };
+static constexpr int  CPU_LEVELS    = sizeof(s_cpuLevels) / sizeof(s_cpuLevels[0]);
+static int      s_cpuLevel    = 0;
+static uint64_t s_cpuUs[CPU_LEVELS];
+static uint64_t s_cpuMarkUs   = 0;
+static uint64_t s_cpuSwitches = 0;
+
+static int cpuLevelOf(uint32_t mhz) {
+    for (int i = 0; i < CPU_LEVELS; i++)
+        if (s_cpuLevels[i] == mhz) return i;
+    return -1;
+}
+
+uint64_t cpuClockUs(uint32_t mhz) {
+    int i = cpuLevelOf(mhz);
+    if (i < 0) return 0;
+    return s_cpuUs[i] + (i == s_cpuLevel ? s_nowUs - s_cpuMarkUs : 0);
+}
+
+uint64_t cpuClockSwitches() { return s_cpuSwitches; }
+} // namespace sim
+
+bool setCpuFrequencyMhz(uint32_t cpu_freq_mhz) {
+    int i = sim::cpuLevelOf(cpu_freq_mhz);
+    if (i < 0) return false;
+    if (i == sim::s_cpuLevel) return true;
+    sim::s_cpuUs[sim::s_cpuLevel] += sim::s_nowUs - sim::s_cpuMarkUs;
+    sim::s_cpuMarkUs = sim::s_nowUs;
+    sim::s_cpuLevel  = i;
+    sim::s_cpuSwitches++;
+    return true;
+}
+
+uint32_t getCpuFrequencyMhz() {
+    return sim::s_cpuLevels[sim::s_cpuLevel];
+}
+
+// Аппаратный ГСЧ — на хосте детерминированный, как и шум датчика
+uint32_t esp_random() {
+    static uint32_t s = 0x9E3779B9u;
+    s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+    return s;
+}
+
+uint32_t EspClass::getCycleCount() {
+    return (uint32_t)(sim::s_nowUs * getCpuFreqMHz());
+}
+
+void EspClass::restart() {
+    throw sim::Restart();
+}
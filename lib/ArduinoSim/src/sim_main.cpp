@@ -0,0 +1,304 @@
+// ============================================
+// Стенд хост-симуляции: main() вместо ядра Arduino
+// ============================================
+// Прогоняет setup() и loop() прошивки в виртуальном времени, подкидывает
+// HTTP-опросы "как от открытых вкладок дашборда" и WebSocket-клиентов,
+// в конце печатает отчёт: длительность итераций loop(), задержки
+// обработчиков, выделения кучи на запрос, трафик.
+//
+//   .pio/build/native/program --days 7 --clients 3
+//   .pio/build/native/program --hours 2 --battery --verbose
+//   .pio/build/native/program --hours 2 --clients 3 --ws 0   # опросы вместо WS
+
+#include <Arduino.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "boot_timeline.h"
+#include "sim.h"
+#include "WebServer.h"
+#include "WebSocketsServer.h"
+#include "Wire.h"
+
+// В `pio test -e native` main() даёт Unity — стенд не нужен целиком
+#ifndef PIO_UNIT_TESTING
+
+namespace {
+
+struct Options {
+    double   seconds  = 86400.0;   // Сколько виртуального времени прогнать
+    int      clients  = 1;         // Открытых вкладок дашборда
+    int      ws       = -1;        // WebSocket-клиентов (по умолчанию = clients)
+    bool     battery  = false;
+    bool     verbose  = false;
+    bool     etag     = true;      // Вкладки переспрашивают с If-None-Match
+};
+
+void usage(const char* argv0) {
+    printf("Usage: %s [--days N | --hours N | --minutes N | --seconds N]\n"
+           "          [--clients N] [--ws N] [--battery] [--verbose] [--no-etag]\n", argv0);
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if      (!strcmp(a, "--days")    && v) { o.seconds = atof(v) * 86400.0; i++; }
+        else if (!strcmp(a, "--hours")   && v) { o.seconds = atof(v) * 3600.0;  i++; }
+        else if (!strcmp(a, "--minutes") && v) { o.seconds = atof(v) * 60.0;    i++; }
+        else if (!strcmp(a, "--seconds") && v) { o.seconds = atof(v);           i++; }
+        else if (!strcmp(a, "--clients") && v) { o.clients = atoi(v);           i++; }
+        else if (!strcmp(a, "--ws")      && v) { o.ws      = atoi(v);           i++; }
+        else if (!strcmp(a, "--battery"))      { o.battery = true; }
+        else if (!strcmp(a, "--verbose"))      { o.verbose = true; }
+        else if (!strcmp(a, "--no-etag"))      { o.etag    = false; }
+        else { usage(argv[0]); return false; }
+    }
+    if (o.ws < 0) o.ws = o.clients;
+    return true;
+}
+
+// --------------------------------------------
+// Гистограмма: октавы по 8 линейных корзин (погрешность перцентиля < 12.5%)
+// --------------------------------------------
+struct Histogram {
+    static constexpr int SUB     = 8;
+    static constexpr int BUCKETS = 64 * SUB;
+
+    uint64_t buckets[BUCKETS] = {};
+    uint64_t count = 0;
+    uint64_t sum   = 0;
+    uint64_t min   = UINT64_MAX;
+    uint64_t max   = 0;
+
+    static int bucketOf(uint64_t v) {
+        if (v < SUB) return (int)v;
+        int msb = 63 - __builtin_clzll(v);
+        int sub = (int)((v >> (msb - 3)) & (SUB - 1));
+        return (msb - 2) * SUB + sub;
+    }
+
+    static uint64_t upperBound(int b) {
+        if (b < SUB) return (uint64_t)b;
+        int msb = b / SUB + 2;
+        int sub = b % SUB;
+        return ((uint64_t)(SUB + sub + 1) << (msb - 3)) - 1;
+    }
+
+    void add(uint64_t v) {
+        buckets[bucketOf(v)]++;
+        count++;
+        sum += v;
+        if (v < min) min = v;
+        if (v > max) max = v;
+    }
+
+    uint64_t percentile(double p) const {
+        uint64_t target = (uint64_t)(p * count), acc = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            acc += buckets[b];
+            if (acc > target) return upperBound(b) < max ? upperBound(b) : max;
+        }
+        return max;
+    }
+};
+
+// --------------------------------------------
+// Опросы дашборда: те же интервалы, что в html_pages.h
+// --------------------------------------------
+struct Poller {
+    const char* uri;
+    uint64_t    periodMs;
+    uint64_t    nextMs;
+};
+
+// --------------------------------------------
+// Оценка тока чипа по времени в каждом режиме (типовые цифры даташита
+// ESP32-C3, 160 МГц, без радио: радио в modem sleep одинаково при любом
+// расписании loop() и на сравнение не влияет)
+// --------------------------------------------
+constexpr double CURRENT_ACTIVE_MA = 23.0;    // CPU работает
+constexpr double CURRENT_IDLE_MA   = 16.0;    // delay(): WFI, тактовая включена
+
+// false — проверка отчёта не прошла (см. "CHECK FAILED")
+bool printReport(const Options& o, uint64_t iterations, const Histogram& loopHist,
+                 uint64_t busyUs, uint64_t elapsedUs, double hostSec,
+                 const sim::HeapStats& heapAfterSetup, const char* endReason) {
+    const sim::HeapStats& h = sim::heap();
+
+    printf("\n==================== SIMULATION REPORT ====================\n");
+    printf("Virtual time:     %.1f h (%s)\n", elapsedUs / 3.6e9, endReason);
+    printf("Host wall time:   %.2f s (x%.0f real time)\n", hostSec,
+           hostSec > 0 ? elapsedUs / 1e6 / hostSec : 0.0);
+    printf("Power:            %s   clients: %d   ws: %d\n",
+           o.battery ? "battery" : "USB", o.clients, o.ws);
+
+    printf("\n-- Boot (ms after start) --\n");
+    for (int i = 0; i < (int)BootMark::COUNT; i++) {
+        uint32_t at = BootTimeline::at((BootMark)i);
+        if (at) printf("%-14s %6lu\n", BootTimeline::name((BootMark)i), (unsigned long)at);
+        else    printf("%-14s %6s\n", BootTimeline::name((BootMark)i), "-");
+    }
+    if (BootTimeline::recentBoots()) {
+        const BootRecord& r = BootTimeline::boot(0);
+        printf("Stages us:       ");
+        for (int i = 0; i < (int)BootStage::COUNT; i++)
+            printf(" %s %lu", BootTimeline::name((BootStage)i), (unsigned long)r.us[i]);
+        printf("\n");
+    }
+
+    printf("\n-- loop() --\n");
+    printf("Iterations:       %llu\n", (unsigned long long)iterations);
+    printf("Period us:        min %llu  avg %llu  p50 <=%llu  p99 <=%llu  max %llu\n",
+           (unsigned long long)loopHist.min,
+           (unsigned long long)(loopHist.count ? loopHist.sum / loopHist.count : 0),
+           (unsigned long long)loopHist.percentile(0.50),
+           (unsigned long long)loopHist.percentile(0.99),
+           (unsigned long long)loopHist.max);
+    printf("Busy (non-delay): %.2f%% of virtual time\n",
+           elapsedUs ? 100.0 * busyUs / elapsedUs : 0.0);
+    uint64_t idleUs = elapsedUs > busyUs ? elapsedUs - busyUs : 0;
+    uint64_t at160 = sim::cpuClockUs(160), at80 = sim::cpuClockUs(80);
+    printf("CPU clock:        160 MHz %.2f%%, 80 MHz %.2f%% (%llu switches)\n",
+           elapsedUs ? 100.0 * at160 / elapsedUs : 0.0,
+           elapsedUs ? 100.0 * at80 / elapsedUs : 0.0,
+           (unsigned long long)sim::cpuClockSwitches());
+    printf("Chip current:     ~%.2f mA average (projected from the time split)\n",
+           elapsedUs ? (CURRENT_ACTIVE_MA * busyUs + CURRENT_IDLE_MA * idleUs) / elapsedUs
+                     : 0.0);
+
+    const sim::I2CStats& i2c = sim::i2cStats();
+    printf("I2C:              %llu transactions, %llu bytes, %.1f s on bus\n",
+           (unsigned long long)i2c.transactions, (unsigned long long)i2c.bytes,
+           i2c.busyUs / 1e6);
+
+    printf("\n-- HTTP --\n");
+    printf("%-12s %8s %10s %10s %10s %10s %10s\n",
+           "route", "reqs", "host us", "max us", "virt ms", "allocs/req", "bytes/req");
+    size_t n = 0;
+    const sim::HttpRouteStats* routes = sim::httpRoutes(&n);
+    for (size_t i = 0; i < n; i++) {
+        const sim::HttpRouteStats& r = routes[i];
+        if (!r.requests) continue;
+        printf("%-12s %8llu %10.1f %10.1f %10.2f %10.1f %10llu\n", r.path,
+               (unsigned long long)r.requests,
+               r.hostNs / 1e3 / r.requests, r.maxHostNs / 1e3,
+               r.virtualUs / 1e3 / r.requests,
+               (double)r.allocs / r.requests,
+               (unsigned long long)(r.wireBytes / r.requests));
+    }
+
+    // Каждая вкладка сначала грузит страницу. Не ответили — стенд теряет
+    // запросы, и остальным цифрам отчёта верить нельзя
+    uint64_t pages = 0;
+    for (size_t i = 0; i < n; i++)
+        if (!strcmp(routes[i].path, "/")) pages = routes[i].requests;
+    bool pagesServed = pages >= (uint64_t)o.clients;
+    printf("Page loads:       %llu of %d%s\n", (unsigned long long)pages, o.clients,
+           pagesServed ? "" : "   CHECK FAILED");
+
+    const sim::WsStats& ws = sim::wsStats();
+    printf("\n-- WebSocket --\n");
+    printf("Messages:         %llu (%llu frames, %llu bytes)\n",
+           (unsigned long long)ws.messages, (unsigned long long)ws.frames,
+           (unsigned long long)ws.bytes);
+
+    printf("\n-- Heap --\n");
+    uint64_t loopAllocs = h.allocs - heapAfterSetup.allocs;
+    printf("Allocations:      %llu total, %llu in loop() (%.2f per iteration)\n",
+           (unsigned long long)h.allocs, (unsigned long long)loopAllocs,
+           iterations ? (double)loopAllocs / iterations : 0.0);
+    printf("Bytes allocated:  %llu\n", (unsigned long long)h.bytes);
+    printf("Live:             %zu B after setup, %zu B now, peak %zu B\n",
+           heapAfterSetup.live, h.live, h.peak);
+    printf("===========================================================\n");
+    return pagesServed;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!parseArgs(argc, argv, o)) return 2;
+
+    sim::setSerialEcho(o.verbose);
+    sim::httpBrowserCache(o.etag);
+
+    // Разводка платы — из той же config.h, что у прошивки
+    sim::Power& pw = sim::power();
+    pw.chrgPin      = BATTERY_CHRG_PIN;
+    pw.stdbyPin     = BATTERY_STDBY_PIN;
+    pw.adcPin       = BATTERY_ADC_PIN;
+    pw.dividerRatio = BATTERY_DIVIDER_RATIO;
+    pw.usb          = !o.battery;
+    pw.batteryVoltage = o.battery ? 4.05f : 4.15f;
+    pw.drainVPerHour  = o.battery ? 0.010f : 0.0f;
+
+    const uint64_t endUs = (uint64_t)(o.seconds * 1e6);
+    auto host0 = std::chrono::steady_clock::now();
+
+    Histogram        loopHist;
+    uint64_t         iterations = 0;
+    uint64_t         busyUs     = 0;
+    sim::HeapStats   afterSetup;
+    const char*      endReason  = "completed";
+
+    try {
+        setup();
+        afterSetup = sim::heap();
+
+        // Каждая вкладка: страница один раз, дальше периодические опросы.
+        // Вкладка с живым WebSocket получает снимки пушем и не опрашивает —
+        // опросы остаются только у вкладок без WS (--ws меньше --clients)
+        const int pollingTabs = o.clients > o.ws ? o.clients - o.ws : 0;
+        Poller pollers[] = {
+            { "/data",    10000, 0 },
+            { "/stats",   10000, 0 },
+            { "/history", 15000, 0 },
+        };
+        for (int c = 0; c < o.clients; c++) sim::httpGet("/");
+        for (int c = 0; c < o.ws; c++) sim::wsConnect();
+
+        const uint64_t setupUs = sim::nowUs();
+        for (Poller& p : pollers) p.nextMs = setupUs / 1000 + p.periodMs;
+
+        while (sim::nowUs() < endUs) {
+            uint64_t nowMs = sim::nowUs() / 1000;
+            for (Poller& p : pollers) {
+                if (nowMs >= p.nextMs) {
+                    for (int c = 0; c < pollingTabs; c++) sim::httpGet(p.uri);
+                    p.nextMs += p.periodMs;
+                }
+            }
+
+            if (o.battery) {
+                double hours = (sim::nowUs() - setupUs) / 3.6e9;
+                pw.batteryVoltage = 4.05f - (float)(pw.drainVPerHour * hours);
+            }
+
+            uint64_t t0 = sim::nowUs(), idle0 = sim::idleUs();
+            loop();
+            uint64_t dt = sim::nowUs() - t0;
+            loopHist.add(dt);
+            busyUs += dt - (sim::idleUs() - idle0);
+            iterations++;
+        }
+    } catch (const sim::DeepSleep& e) {
+        static char reason[64];
+        snprintf(reason, sizeof(reason), "deep sleep requested for %llu s",
+                 (unsigned long long)(e.durationUs / 1000000ULL));
+        endReason = reason;
+    } catch (const sim::Restart&) {
+        endReason = "ESP.restart()";
+    }
+
+    double hostSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - host0).count();
+    fflush(stdout);
+    bool ok = printReport(o, iterations, loopHist, busyUs, sim::nowUs(), hostSec,
+                          afterSetup, endReason);
+    return ok ? 0 : 1;
+}
+#endif // PIO_UNIT_TESTING
@@ -0,0 +1,33 @@
+// Сон и сброс: на хосте не возвращаются, а бросают исключение стенду
+#include "esp_sleep.h"
+#include "esp_system.h"
+#include "sim.h"
+
+namespace sim {
+
+static esp_sleep_wakeup_cause_t s_wakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+static uint64_t                 s_timerWakeUs = 0;
+
+void setWakeupCause(int cause) {
+    s_wakeCause = static_cast<esp_sleep_wakeup_cause_t>(cause);
+}
+
+} // namespace sim
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() {
+    return sim::s_wakeCause;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us) {
+    sim::s_timerWakeUs = time_in_us;
+    return ESP_OK;
+}
+
+void esp_deep_sleep_start() {
+    throw sim::DeepSleep(sim::s_timerWakeUs);
+}
+
+esp_reset_reason_t esp_reset_reason() {
+    return sim::s_wakeCause == ESP_SLEEP_WAKEUP_TIMER ? ESP_RST_DEEPSLEEP
+                                                       : ESP_RST_POWERON;
+}
@@ -0,0 +1,38 @@
+#include "alloc_counter.h"
+#include <stddef.h>
+
+#ifdef ALLOC_COUNTER
+
+// Из нескольких задач инкремент не атомарный — для статистики этого хватает
+static volatile uint32_t s_allocs = 0;
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    s_allocs = s_allocs + 1;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t n, size_t size) {
+    s_allocs = s_allocs + 1;
+    return __real_calloc(n, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    if (size) s_allocs = s_allocs + 1;   // realloc(p, 0) — это free
+    return __real_realloc(ptr, size);
+}
+}
+
+uint32_t AllocCounter::count()   { return s_allocs; }
+bool     AllocCounter::enabled() { return true; }
+
+#else
+
+uint32_t AllocCounter::count()   { return 0; }
+bool     AllocCounter::enabled() { return false; }
+
+#endif // ALLOC_COUNTER
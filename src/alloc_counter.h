@@ -0,0 +1,20 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <stdint.h>
+
+// ============================================
+// Счётчик выделений кучи
+// ============================================
+// Считает вызовы malloc/calloc/realloc через --wrap линкера (флаги
+// в platformio.ini вместе с -D ALLOC_COUNTER). Сюда попадает всё, что
+// идёт через libc: String, new, WebServer. Прямые heap_caps_malloc()
+// драйвера WiFi — нет, и это к лучшему: меньше шума от чужих задач.
+//
+// Без ALLOC_COUNTER count() всегда 0, enabled() == false.
+namespace AllocCounter {
+    uint32_t count();
+    bool     enabled();
+}
+
+#endif // ALLOC_COUNTER_H
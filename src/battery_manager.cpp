@@ -298,6 +298,14 @@ bool BatteryManager::isCriticalBattery() const {
 // Строковые представления
 // ============================================
 String BatteryManager::getStatusString() const {
+    return getStatusName();
+}
+
+String BatteryManager::getPowerSourceString() const {
+    return getPowerSourceName();
+}
+
+const char* BatteryManager::getStatusName() const {
     switch (_chargeStatus) {
         case ChargeStatus::CHARGING:    return "Charging";
         case ChargeStatus::CHARGED:     return "Fully charged";
@@ -308,20 +316,20 @@ String BatteryManager::getStatusString() const {
     }
 }
 
-String BatteryManager::getPowerSourceString() const {
+const char* BatteryManager::getPowerSourceName() const {
     return (_powerSource == PowerSource::USB) ? "USB" : "Battery";
 }
 
 String BatteryManager::getSummaryString() const {
-    String s;
-    s.reserve(64);
-    s += String(_voltage, 2) + "V | ";
-    s += String(_percent) + "% | ";
-    s += getStatusString();
-    s += " (" + getPowerSourceString() + ")";
-    if (isCriticalBattery())
-        s += " ‼ CRITICAL";
-    else if (isLowBattery())
-        s += " ⚠ LOW";
-    return s;
+    char buf[64];
+    formatSummary(buf, sizeof(buf));
+    return String(buf);
+}
+
+void BatteryManager::formatSummary(char* out, size_t len) const {
+    const char* mark = isCriticalBattery() ? " ‼ CRITICAL"
+                     : isLowBattery()      ? " ⚠ LOW"
+                     : "";
+    snprintf(out, len, "%.2fV | %d%% | %s (%s)%s",
+             _voltage, _percent, getStatusName(), getPowerSourceName(), mark);
 }
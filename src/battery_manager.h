@@ -47,7 +47,10 @@ public:
     // Строковые представления для логов
     String getStatusString()     const;
     String getPowerSourceString() const;
+    const char* getStatusName()      const;  // То же без String
+    const char* getPowerSourceName() const;
     String getSummaryString()    const;  // "3.85V | 72% | Charging"
+    void   formatSummary(char* out, size_t len) const;   // То же без String
 
 private:
     int _adcPin;
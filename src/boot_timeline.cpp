@@ -0,0 +1,105 @@
+#include "boot_timeline.h"
+#include <Arduino.h>
+#include <esp_system.h>
+#include <string.h>
+
+namespace {
+    constexpr int      MARKS        = (int)BootMark::COUNT;
+    constexpr int      STAGES       = (int)BootStage::COUNT;
+    constexpr uint32_t HISTORY_MAGIC = 0x424F4F54;   // "BOOT"
+
+    uint32_t s_at[MARKS];
+    uint32_t s_startUs[STAGES];
+
+    // Без begin() (тесты, стенд) пишем во временное кольцо в RAM
+    BootHistory  s_local;
+    BootHistory* s_history = &s_local;
+    BootRecord*  s_current = &s_local.records[0];
+
+    const char* const MARK_NAMES[MARKS] = {
+        "serial", "wifiStart", "firstSample", "setupDone",
+        "wifiConnected", "banner", "firstHttp"
+    };
+
+    const char* const STAGE_NAMES[STAGES] = {
+        "setup", "serial", "battery", "i2c", "display", "sensor", "wifi", "web"
+    };
+
+    bool historyValid(const BootHistory* h) {
+        return h->magic == HISTORY_MAGIC && h->next < BOOT_HISTORY &&
+               h->count <= BOOT_HISTORY;
+    }
+}
+
+namespace BootTimeline {
+
+void begin(BootHistory* history, uint32_t bootCount, uint8_t resetReason) {
+    if (!historyValid(history)) {
+        memset(history, 0, sizeof(*history));
+        history->magic = HISTORY_MAGIC;
+    }
+    s_history = history;
+    s_current = &history->records[history->next];
+    history->next = (history->next + 1) % BOOT_HISTORY;
+    if (history->count < BOOT_HISTORY) history->count++;
+
+    memset(s_current, 0, sizeof(*s_current));
+    s_current->boot   = bootCount;
+    s_current->reason = resetReason;
+    strncpy(s_current->fw, FIRMWARE_VERSION, sizeof(s_current->fw) - 1);
+}
+
+void mark(BootMark m) {
+    uint32_t& at = s_at[(int)m];
+    if (at) return;
+    at = millis();
+    if (!at) at = 1;   // 0 занят под "не было"
+}
+
+uint32_t at(BootMark m) {
+    return s_at[(int)m];
+}
+
+const char* name(BootMark m) {
+    return MARK_NAMES[(int)m];
+}
+
+void start(BootStage s) {
+    s_startUs[(int)s] = micros();
+}
+
+void end(BootStage s) {
+    uint32_t& us = s_current->us[(int)s];
+    us = micros() - s_startUs[(int)s];
+    if (!us) us = 1;
+}
+
+const char* name(BootStage s) {
+    return STAGE_NAMES[(int)s];
+}
+
+size_t recentBoots() {
+    return s_history->count;
+}
+
+const BootRecord& boot(size_t i) {
+    size_t idx = (s_history->next + BOOT_HISTORY - 1 - i) % BOOT_HISTORY;
+    return s_history->records[idx];
+}
+
+const char* reasonName(uint8_t reason) {
+    switch ((esp_reset_reason_t)reason) {
+        case ESP_RST_POWERON:   return "poweron";
+        case ESP_RST_EXT:       return "ext";
+        case ESP_RST_SW:        return "sw";
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:
+        case ESP_RST_TASK_WDT:
+        case ESP_RST_WDT:       return "wdt";
+        case ESP_RST_DEEPSLEEP: return "deepsleep";
+        case ESP_RST_BROWNOUT:  return "brownout";
+        default:                return "unknown";
+    }
+}
+
+} // namespace BootTimeline
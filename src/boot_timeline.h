@@ -0,0 +1,86 @@
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// ============================================
+// Вехи и этапы загрузки
+// ============================================
+// Вехи — когда (millis() от старта) устройство прошло ключевые точки:
+// запуск ассоциации WiFi, первый замер, конец setup(), подключение, баннер
+// и первый ответ по HTTP. Ставится отметка один раз — повторный mark()
+// ничего не меняет, поэтому звать можно прямо из горячих путей:
+//
+//   BootTimeline::mark(BootMark::FIRST_HTTP);   // В handleClient()
+//
+// Этапы — сколько мкс занял каждый шаг инициализации:
+//
+//   BootTimeline::start(BootStage::BATTERY);
+//   batteryManager.begin();
+//   BootTimeline::end(BootStage::BATTERY);
+//
+// Этапы пишутся сразу в RTC-память (BootHistory): кольцо последних
+// BOOT_HISTORY загрузок переживает deep sleep и программный сброс, а
+// загрузка, зависшая на полпути, остаётся в истории с недописанными
+// этапами. Всё это отдаётся в /stats ("boot").
+enum class BootMark : uint8_t {
+    SERIAL_READY,    // Serial поднят (и дождались хоста, если ждали)
+    WIFI_START,      // WiFi.begin() — дальше ассоциация идёт в фоне
+    FIRST_SAMPLE,    // Первый замер AHT10
+    SETUP_DONE,      // Конец setup()
+    WIFI_CONNECTED,  // Получен IP
+    BANNER,          // Баннер ушёл в лог — его уже есть кому принять
+    FIRST_HTTP,      // Отдан первый HTTP-ответ
+    COUNT
+};
+
+enum class BootStage : uint8_t {
+    SETUP,     // Весь setup()
+    SERIAL,    // Serial.begin() и ожидание хоста
+    BATTERY,   // batteryManager.begin(): три медианы ADC
+    I2C,       // Wire.begin() + setClock() и пауза после
+    DISPLAY,   // Проба SSD1306 и заставка
+    SENSOR,    // Инициализация AHT10 и первое чтение
+    WIFI,      // От WiFi.begin() до IP — идёт в фоне, внахлёст с остальными
+    WEB,       // webServer.begin()
+    COUNT
+};
+
+// Одна загрузка. 0 в этапе — не завершился (или не начинался)
+struct BootRecord {
+    uint32_t boot;        // g_bootCount
+    uint8_t  reason;      // esp_reset_reason_t
+    char     fw[11];      // FIRMWARE_VERSION
+    uint32_t us[(int)BootStage::COUNT];
+};
+
+// Кольцо загрузок. Живёт в RTC_NOINIT_ATTR в main.cpp: в отличие от
+// RTC_DATA_ATTR переживает и программный сброс/сторож, а после включения
+// питания там мусор — его отсекает magic
+struct BootHistory {
+    uint32_t   magic;
+    uint8_t    next;
+    uint8_t    count;
+    BootRecord records[BOOT_HISTORY];
+};
+
+namespace BootTimeline {
+    // Открыть запись текущей загрузки — первым делом в setup()
+    void begin(BootHistory* history, uint32_t bootCount, uint8_t resetReason);
+
+    void        mark(BootMark m);
+    uint32_t    at(BootMark m);          // 0 — ещё не было
+    const char* name(BootMark m);        // "serial", "wifiStart", ...
+
+    void        start(BootStage s);
+    void        end(BootStage s);
+    const char* name(BootStage s);       // "setup", "serial", ...
+
+    size_t            recentBoots();     // Сколько в кольце
+    const BootRecord& boot(size_t i);    // 0 — текущая загрузка
+    const char*       reasonName(uint8_t reason);   // "poweron", "deepsleep", ...
+}
+
+#endif // BOOT_TIMELINE_H
@@ -1,7 +1,165 @@
 #include "calculations.h"
 #include <math.h>
 
+// ============================================
+// Таблица ln(m), m ∈ [1, 2] — генерируется компилятором
+// ============================================
+// ln(m) = 2·atanh(z), z = (m − 1)/(m + 1). На [1, 2] |z| ≤ 1/3, так что
+// 20 членов ряда дают точность double. На устройстве от этого остаются
+// только 65 констант во flash — ни одной float-операции в рантайме.
+static constexpr int LN_SEGMENTS_LOG2 = 6;
+static constexpr int LN_SEGMENTS      = 1 << LN_SEGMENTS_LOG2;   // 64 отрезка
+
+static constexpr double lnSeries(double m) {
+    double z = (m - 1.0) / (m + 1.0);
+    double z2 = z * z, term = z, sum = 0.0;
+    for (int k = 1; k < 40; k += 2) {
+        sum  += term / k;
+        term *= z2;
+    }
+    return 2.0 * sum;
+}
+
+static constexpr int32_t toQ16(double v) {
+    return (int32_t)(v * 65536.0 + (v >= 0 ? 0.5 : -0.5));
+}
+
+static constexpr int64_t toQ32(double v) {
+    return (int64_t)(v * 4294967296.0 + (v >= 0 ? 0.5 : -0.5));
+}
+
+struct LnTable {
+    int32_t v[LN_SEGMENTS + 1];
+};
+
+static constexpr LnTable makeLnTable() {
+    LnTable t{};
+    for (int i = 0; i <= LN_SEGMENTS; i++) {
+        t.v[i] = toQ16(lnSeries(1.0 + (double)i / LN_SEGMENTS));
+    }
+    return t;
+}
+
+static constexpr LnTable LN_TABLE    = makeLnTable();
+static constexpr int32_t LN2_Q16     = toQ16(lnSeries(2.0));
+// ln(10000) = 13·ln2 + ln(10000 / 8192)
+static constexpr int32_t LN10000_Q16 = toQ16(13.0 * lnSeries(2.0) + lnSeries(10000.0 / 8192.0));
+
+// ln(x) в Q16 для целого x ≥ 1: x = 2^e·m, ln x = e·ln2 + ln m,
+// ln m — по таблице с линейной интерполяцией (погрешность < 3e-5)
+static int32_t lnQ16(uint32_t x) {
+    int e = 31 - __builtin_clz(x);
+    uint32_t frac = e >= 16 ? (x >> (e - 16)) & 0xFFFF
+                            : (x << (16 - e)) & 0xFFFF;        // Дробная часть m в Q16
+    uint32_t i   = frac >> (16 - LN_SEGMENTS_LOG2);
+    int32_t  rem = (int32_t)(frac & ((1u << (16 - LN_SEGMENTS_LOG2)) - 1));
+    int32_t  y0  = LN_TABLE.v[i];
+    int32_t  y1  = LN_TABLE.v[i + 1];
+    return e * LN2_Q16 + y0 + (((y1 - y0) * rem) >> (16 - LN_SEGMENTS_LOG2));
+}
+
+// Деление с округлением к ближайшему (делитель > 0)
+static int32_t divRound(int32_t num, int32_t den) {
+    return num >= 0 ? (num + den / 2) / den : (num - den / 2) / den;
+}
+
+static int16_t toC100(float v) {
+    if (v < -300.0f) v = -300.0f;   // Диапазон int16 в сотых — ±327
+    if (v >  300.0f) v =  300.0f;
+    return (int16_t)(v * 100.0f + (v >= 0 ? 0.5f : -0.5f));
+}
+
+// ============================================
+// Точка росы (формула Магнуса, a = 17.27, b = 237.7)
+// ============================================
+int16_t WeatherCalculations::dewPointC100(int16_t temp100, uint16_t humid100) {
+    // Те же ограничители, что у float-версии: log(0) не определён
+    if (humid100 < 1)     humid100 = 1;
+    if (humid100 > 10000) humid100 = 10000;
+    int32_t t = temp100;
+    if (t < -4000) t = -4000;     // Рабочий диапазон AHT10
+    if (t >  8500) t =  8500;
+
+    // a·T/(b + T) в Q16. В сотых: 1727·t / (100·(23770 + t)).
+    // Делим в два шага (частное + остаток), чтобы всё уложилось в int32:
+    // |r| < den ≤ 32270, и r·65536 ещё помещается.
+    int32_t num = 1727 * t;
+    int32_t den = 23770 + t;
+    int32_t q   = num / den;
+    int32_t r   = num % den;
+    int32_t alpha = (q * 65536 + (r * 65536) / den) / 100;
+
+    // + ln(RH/100) = ln(humid100) − ln(10000)
+    alpha += lnQ16(humid100) - LN10000_Q16;
+
+    // Td = b·α / (a − α). 23770·α в int32 не влезает, поэтому
+    // 2377·α / ((a − α)/10): |α| ≤ 12.8 → |2377·α| < 2^31
+    static constexpr int32_t A_Q16 = toQ16(17.27);
+    int32_t d = (A_Q16 - alpha + 5) / 10;
+    return (int16_t)divRound(alpha * 2377, d);
+}
+
+// ============================================
+// Heat index (Rothfusz, коэффициенты для °C)
+// ============================================
+// k0 + k1·T + k2·T²: коэффициенты в Q32, T в Q16, результат в Q32
+static int64_t polyQ32(int64_t k0, int64_t k1, int64_t k2, int64_t x) {
+    return k0 + (((k1 + ((k2 * x) >> 16)) * x) >> 16);
+}
+
+int16_t WeatherCalculations::heatIndexC100(int16_t temp100, uint16_t humid100) {
+    // Heat Index is used only at temperatures above 27°C.
+    if (temp100 < 2700) return temp100;
+    if (temp100 > 8500) temp100 = 8500;
+    if (humid100 > 10000) humid100 = 10000;
+
+    static constexpr int64_t C1 = toQ32(-8.78469475556);
+    static constexpr int64_t C2 = toQ32(1.61139411);
+    static constexpr int64_t C3 = toQ32(2.33854883889);
+    static constexpr int64_t C4 = toQ32(-0.14611605);
+    static constexpr int64_t C5 = toQ32(-0.012308094);
+    static constexpr int64_t C6 = toQ32(-0.0164248277778);
+    static constexpr int64_t C7 = toQ32(0.002211732);
+    static constexpr int64_t C8 = toQ32(0.00072546);
+    static constexpr int64_t C9 = toQ32(-0.000003582);
+
+    // T и RH в Q16 (деление 32-битное — на C3 оно аппаратное)
+    int64_t T = ((int32_t)temp100  << 16) / 100;
+    int64_t R = ((int32_t)humid100 << 16) / 100;
+
+    // Та же формула по Горнеру:
+    // HI = (c1 + c2·T + c5·T²) + R·((c3 + c4·T + c7·T²) + R·(c6 + c8·T + c9·T²))
+    int64_t base  = polyQ32(C1, C2, C5, T);
+    int64_t lin   = polyQ32(C3, C4, C7, T);
+    int64_t quad  = polyQ32(C6, C8, C9, T);
+    int64_t inner = lin + ((quad * R) >> 16);
+    int64_t hi    = base + ((inner * R) >> 16);
+
+    int64_t hi100 = (hi * 100 + (1LL << 31)) >> 32;
+    if (hi100 < INT16_MIN) hi100 = INT16_MIN;
+    if (hi100 > INT16_MAX) hi100 = INT16_MAX;
+    return (int16_t)hi100;
+}
+
+// ============================================
+// Float API — обёртки над целочисленными ядрами
+// ============================================
 float WeatherCalculations::calculateDewPoint(float temp, float humid) {
+    if (humid < 0.0f)   humid = 0.0f;
+    if (humid > 100.0f) humid = 100.0f;
+    return dewPointC100(toC100(temp), (uint16_t)toC100(humid)) / 100.0f;
+}
+
+float WeatherCalculations::calculateHeatIndex(float temp, float humid) {
+    if (humid < 0.0f)   humid = 0.0f;
+    if (humid > 100.0f) humid = 100.0f;
+    return heatIndexC100(toC100(temp), (uint16_t)toC100(humid)) / 100.0f;
+}
+
+// ============================================
+// Исходные float-формулы (эталон)
+// ============================================
+float WeatherCalculations::dewPointFloat(float temp, float humid) {
     // Guard: log(0) is undefined — clamp humidity to a safe minimum
     if (humid <= 0.0f) humid = 0.01f;
     if (humid > 100.0f) humid = 100.0f;
@@ -11,7 +169,7 @@ float WeatherCalculations::calculateDewPoint(float temp, float humid) {
     return (b * alpha) / (a - alpha);
 }
 
-float WeatherCalculations::calculateHeatIndex(float temp, float humid) {
+float WeatherCalculations::heatIndexFloat(float temp, float humid) {
     // Heat Index is used only at temperatures above 27°C.
     if (temp < 27) return temp;
     
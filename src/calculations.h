@@ -1,6 +1,8 @@
 #ifndef CALCULATIONS_H
 #define CALCULATIONS_H
 
+#include <stdint.h>
+
 class WeatherCalculations {
 public:
     // Calculate Dew Point
@@ -8,6 +10,17 @@ public:
     
     // Calculate Heat Index
     static float calculateHeatIndex(float temp, float humid);
+
+    // Целочисленные ядра: вход и выход в сотых (°C×100, %RH×100) — тот же
+    // формат, что у упакованной истории. У ESP32-C3 нет FPU, каждая
+    // float-операция (а logf тем более) — вызов soft-float библиотеки.
+    // Обе float-функции выше работают через эти ядра.
+    static int16_t dewPointC100(int16_t temp100, uint16_t humid100);
+    static int16_t heatIndexC100(int16_t temp100, uint16_t humid100);
+
+    // Исходные float-формулы — эталон для теста точности и бенчмарка
+    static float dewPointFloat(float temp, float humid);
+    static float heatIndexFloat(float temp, float humid);
 };
 
 #endif // CALCULATIONS_H
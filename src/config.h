@@ -3,13 +3,26 @@
 
 #include <Arduino.h>
 
+// Версия прошивки: заставка, баннер и история загрузок в /stats —
+// по ней видно, после какой прошивки загрузка стала дольше
+inline const char* FIRMWARE_VERSION = "v3.1";
+
 // ============================================
 // WiFi Configuration
 // ============================================
 inline const char* WIFI_SSID     = "SkyNet";
 inline const char* WIFI_PASSWORD = "password";
 inline constexpr int           WIFI_MAX_RETRY = 30;
-inline constexpr unsigned long WIFI_TIMEOUT   = 15000;
+inline constexpr unsigned long WIFI_TIMEOUT   = 15000;   // Нет сети дольше — "offline" в лог
+
+// Быстрое подключение по BSSID и каналу последней удачной AP из RTC-памяти
+// (WiFiCache): без скана эфира (~2 с радио на каждом пробуждении из сна).
+// Не подключились за WIFI_FAST_CONNECT_TIMEOUT — кэш сбрасывается, дальше скан.
+inline constexpr unsigned long WIFI_FAST_CONNECT_TIMEOUT = 3000;
+// Повторно брать и IP из прошлой аренды DHCP (экономит ещё ~0.2-1 с).
+// Выключено: если роутер успел отдать адрес другому, будет конфликт IP,
+// а подключение при этом "удастся" и до скана дело не дойдёт.
+inline constexpr bool          WIFI_CACHE_DHCP_LEASE     = false;
 
 // ============================================
 // I2C Configuration (ESP32-C3 Super Mini)
@@ -52,12 +65,38 @@ inline constexpr unsigned long SENSOR_INTERVAL        = 30000;  // Опрос д
 inline constexpr unsigned long WIFI_CHECK_INTERVAL    = 300000; // Проверка WiFi каждые 5 мин (было 50 мин!)
 inline constexpr unsigned long STATS_UPDATE_INTERVAL  = 5000;  // Обновление статистики каждые 5 сек
 inline constexpr unsigned long BATTERY_CHECK_INTERVAL = 10000;  // Проверка батареи каждые 10 сек
+inline constexpr unsigned long STATUS_LOG_INTERVAL    = 30000;  // Сводка статуса в лог каждые 30 сек
+
+// Задачи планировщика (scheduler.h). Между сроками loop() спит, поэтому
+// период опроса — это и задержка реакции, и число пробуждений в секунду.
+inline constexpr unsigned long BUTTON_POLL_INTERVAL      = 20;   // Кнопка: короче антидребезга не нужно
+inline constexpr unsigned long BUTTON_POLL_INTERVAL_BATTERY = 40; // На батарее — вдвое меньше пробуждений
+inline constexpr unsigned long WIFI_POLL_INTERVAL        = 500;  // checkConnection() — реконнект сам себя дросселирует
+inline constexpr unsigned long WIFI_CONNECT_POLL_INTERVAL = 50;  // До первого подключения: IP замечаем сразу
+inline constexpr unsigned long WEB_POLL_INTERVAL         = 10;   // HTTP/WS на USB — как прежний delay(10)
+inline constexpr unsigned long WEB_POLL_INTERVAL_BATTERY = 40;   // На батарее — реже просыпаемся
+inline constexpr unsigned long AHT10_POLL_RETRY_MS       = 5;    // AHT10 ещё BUSY после AHT10_CONVERSION_MS
 
 // ============================================
 // History Configuration
 // ============================================
-inline constexpr int HISTORY_SIZE        = 60;   // 60 точек × 30с (SENSOR_INTERVAL) = окно 30 минут
-// HOURLY_HISTORY_SIZE removed — replaced with O(1) running average in SensorManager
+inline constexpr int HISTORY_SIZE        = 120;  // 120 точек × 30с (SENSOR_INTERVAL) = окно 1 час
+
+// Уровни свёртки: сырые точки каскадом сворачиваются в корзины min/max/mean.
+// Точки хранятся упакованными (сотые доли °C/%RH в 16 битах — реальное
+// разрешение AHT10), поэтому глубина вдвое больше, чем с float. Вместе с
+// предвычисленными точкой росы и heat index: 8 Б на сырую точку, 16 Б на
+// корзину — 960 + 9216 + 5376 = 15552 Б статической RAM (без dew/heat
+// было 11424 Б).
+inline constexpr unsigned long HISTORY_5MIN_STEP   = 300000;   // 5 минут
+inline constexpr unsigned long HISTORY_HOURLY_STEP = 3600000;  // 1 час
+inline constexpr int HISTORY_5MIN_SIZE   = 576;  // 576 × 5 мин = 48 часов
+inline constexpr int HISTORY_HOURLY_SIZE = 336;  // 336 × 1 ч   = 14 суток
+
+static_assert(HISTORY_5MIN_STEP % SENSOR_INTERVAL == 0,
+              "5-min bucket must hold a whole number of sensor reads");
+static_assert(HISTORY_HOURLY_STEP % HISTORY_5MIN_STEP == 0,
+              "Hourly bucket must hold a whole number of 5-min buckets");
 
 // ============================================
 // Web Server Configuration
@@ -70,11 +109,56 @@ inline constexpr int WEB_RESPONSE_TIMEOUT = 1000;
 // ============================================
 inline constexpr unsigned long SERIAL_BAUD = 115200;
 
+// Логгер (logger.h). Вызовы ниже LOG_MIN_LEVEL вырезаются при компиляции
+// вместе с вычислением аргументов: 0 — debug, 1 — info, 2 — warn, 3 — error
+inline constexpr int    LOG_MIN_LEVEL = 1;
+inline constexpr size_t LOG_LINE_SIZE = 160;   // Статический буфер одной строки
+
+// Детектор зависаний loop(): проход дольше порога (без финального delay)
+// попадает в кольцо последних зависаний (/stats) и в лог — не чаще
+// раза в LOOP_STALL_LOG_INTERVAL, чтобы постоянный тормоз не забил WS-кольцо
+inline constexpr unsigned long LOOP_STALL_THRESHOLD_MS = 100;
+inline constexpr int           LOOP_STALL_HISTORY      = 4;
+inline constexpr unsigned long LOOP_STALL_LOG_INTERVAL = 1000;   // мс
+
+// Сколько последних загрузок (длительности этапов setup(), мкс) хранить
+// в RTC-памяти для /stats; запись ~48 байт
+inline constexpr int           BOOT_HISTORY            = 4;
+
 // ============================================
 // Memory Configuration
 // ============================================
-inline constexpr size_t JSON_BUFFER_SIZE    = 2048;
-inline constexpr size_t HISTORY_BUFFER_SIZE = 4096;
+// Буферы JsonWriter. /data ~200 байт собирается в кэш объекта.
+// /stats (~2 КБ: профиль фаз loop() ~450, зависания до ~400, история
+// загрузок ~450, duty cycle ~100) и /history идут через буфер-окно на стеке
+// обработчика (стек loop-задачи ~8 КБ) и сливаются в сокет chunked-ответом,
+// поэтому длина тела на стек не влияет.
+inline constexpr size_t DATA_JSON_BUFFER_SIZE  = 384;
+inline constexpr size_t STATS_CHUNK_SIZE       = 512;
+inline constexpr size_t HISTORY_CHUNK_SIZE     = 512;
+
+// Кэш готового тела /history?tier=raw (живёт в WeatherWebServer, не на стеке).
+// 120 точек: ~3.3 КБ в обычных условиях, ~4.2 КБ при худших значениях.
+// Свёртки (5m/1h) в десятки КБ не кэшируются — стримятся как есть.
+inline constexpr size_t HISTORY_CACHE_SIZE     = 4608;
+
+// WS-снимок {"t":"sample","data":{...},"stats":{...},"point":{...}}:
+// тело /data (~250 байт) + изменчивые поля /stats с батареей (~350 байт)
+// + точка истории, всего ~600 байт. Буфер живёт в WeatherWebServer;
+// не влезший снимок не шлётся и считается в /stats (push.overflows)
+inline constexpr size_t WS_PUSH_BUFFER_SIZE    = 1024;
+
+// Лог для WS-клиентов: broadcastLog() только дописывает строку в общее
+// кольцо, раз за проход loop() каждый клиент получает накопленное одним
+// кадром. Отставшему клиенту затираются старые строки.
+// Новый клиент сначала получает историю — последние LOG_REPLAY_SIZE байт
+// кольца (баннер setup() ~1 КБ + несколько блоков printStatus() ~600 байт),
+// тоже по кадру за проход, чтобы повтор не задерживал чтение датчика.
+inline constexpr size_t LOG_RING_SIZE          = 4096;
+inline constexpr size_t LOG_REPLAY_SIZE        = 4096;   // 0 — без истории
+inline constexpr size_t LOG_FRAME_SIZE         = 1024;   // Кадр — на стеке
+static_assert(LOG_REPLAY_SIZE <= LOG_RING_SIZE,
+              "Log replay is served from the log ring");
 
 // ============================================
 // System Limits
@@ -92,6 +176,13 @@ inline constexpr float TEMP_MAX_VALID  = 85.0;
 inline constexpr float HUMID_MIN_VALID = 0.0;
 inline constexpr float HUMID_MAX_VALID = 100.0;
 
+// Неблокирующее чтение AHT10: триггер → ждём → опрос BUSY → 6 байт.
+// По даташиту преобразование ~75 мс; раньше этого статус не опрашиваем —
+// каждый опрос это лишняя транзакция на общей с OLED шине.
+inline constexpr uint8_t       AHT10_I2C_ADDR      = 0x38;
+inline constexpr unsigned long AHT10_CONVERSION_MS = 75;
+inline constexpr unsigned long AHT10_TIMEOUT_MS    = 300;  // Дольше — считаем ошибкой чтения
+
 // ============================================
 // Battery Configuration
 // ============================================
@@ -124,6 +215,16 @@ inline constexpr unsigned long LOW_BATTERY_LOG_INTERVAL = 300000;
 // ценой чуть большей задержки ответа веб-интерфейса). На USB — отключается.
 inline constexpr bool WIFI_POWER_SAVE_ON_BATTERY = true;
 
+// Частота CPU на батарее (cpu_freq.h): простой — на CPU_FREQ_IDLE_MHZ,
+// веб-запрос, WS-рассылка и кадр OLED — под блокировкой на CPU_FREQ_MAX_MHZ.
+// Ниже 80 МГц нельзя: WiFi и шина APB (I2C, ADC) тактуются от 80 МГц.
+inline constexpr bool     CPU_FREQ_SCALING_ON_BATTERY = true;
+inline constexpr uint32_t CPU_FREQ_MAX_MHZ            = 160;
+inline constexpr uint32_t CPU_FREQ_IDLE_MHZ           = 80;
+
+static_assert(CPU_FREQ_IDLE_MHZ >= 80 && CPU_FREQ_IDLE_MHZ <= CPU_FREQ_MAX_MHZ,
+              "WiFi and the APB bus need at least 80 MHz");
+
 // ============================================
 // OLED Display Configuration (SSD1306 0.96" 128x64, I2C)
 // ============================================
@@ -156,6 +257,16 @@ inline constexpr unsigned long DISPLAY_AUTO_ROTATE_INTERVAL = 8000;
 inline constexpr unsigned long BUTTON_DEBOUNCE_MS   = 50;   // Антидребезг
 inline constexpr unsigned long BUTTON_LONG_PRESS_MS = 800;  // Порог долгого нажатия
 
+static_assert(BUTTON_POLL_INTERVAL < BUTTON_DEBOUNCE_MS,
+              "button must be sampled at least once per debounce window");
+static_assert(BUTTON_POLL_INTERVAL_BATTERY < BUTTON_DEBOUNCE_MS,
+              "button must be sampled at least once per debounce window");
+// Сроки задач лежат на общей сетке: при кратных периодах кнопка и веб
+// просыпаются вместе, а не двумя отдельными пробуждениями
+static_assert(WEB_POLL_INTERVAL_BATTERY % BUTTON_POLL_INTERVAL_BATTERY == 0 &&
+              BUTTON_POLL_INTERVAL % WEB_POLL_INTERVAL == 0,
+              "button and web poll periods should be multiples of each other");
+
 // ============================================
 // Deep Sleep Configuration
 // ============================================
@@ -173,4 +284,22 @@ inline constexpr uint64_t DEEP_SLEEP_MAX_DURATION = 60ULL * 60 * 1000000;
 // Минимальное время работы перед deep sleep (30 секунд)
 inline constexpr unsigned long MIN_UPTIME_BEFORE_SLEEP = 30000;
 
+// Duty cycle на батарее (duty_cycle.h): просыпаемся раз в SENSOR_INTERVAL
+// только ради AHT10 (без WiFi, дисплея и веб-сервера), сэмпл — в
+// RTC-кольцо, и снова deep sleep. Каждое DUTY_CYCLE_FLUSH_EVERY-е
+// пробуждение — полная загрузка: пачка уходит в /history, веб доступен
+// DUTY_CYCLE_AWAKE_MS. Выключено по умолчанию: в этом режиме веб-интерфейс
+// отвечает только в окнах сброса, а кнопка чип из deep sleep не будит
+// (GPIO10 не из RTC-домена). Сон переживает только кольцо: история,
+// свёртки 5 мин / 1 ч и min/max после каждого сброса — лишь из пачки
+// (~14 КБ колец в 8 КБ RTC-памяти C3 не помещаются).
+inline constexpr bool          DUTY_CYCLE_ON_BATTERY   = false;
+inline constexpr int           DUTY_CYCLE_BUFFER       = 120;   // Сэмплов по 4 байта в RTC: час при 30 с
+inline constexpr int           DUTY_CYCLE_FLUSH_EVERY  = 60;    // Полчаса при 30 с
+inline constexpr int           DUTY_CYCLE_FLUSH_MARGIN = 8;     // "Почти полное" кольцо
+inline constexpr unsigned long DUTY_CYCLE_AWAKE_MS     = 60000; // Окно сброса
+
+static_assert(DUTY_CYCLE_FLUSH_MARGIN < DUTY_CYCLE_BUFFER,
+              "flush margin must leave room in the RTC sample ring");
+
 #endif // CONFIG_H
@@ -0,0 +1,70 @@
+#include "cpu_freq.h"
+#include "config.h"
+#include <Arduino.h>
+
+namespace {
+    bool          s_scaling  = false;
+    int           s_locks    = 0;
+    int           s_level    = 1;
+    uint32_t      s_switches = 0;
+    uint64_t      s_levelUs[CpuFreq::LEVELS];
+    unsigned long s_mark     = 0;
+
+    void account() {
+        unsigned long now = micros();
+        s_levelUs[s_level] += now - s_mark;
+        s_mark = now;
+    }
+
+    // Нужный уровень — из режима и блокировок; частоту трогаем, только если он сменился
+    void apply() {
+        account();
+        int want = (!s_scaling || s_locks > 0) ? 1 : 0;
+        if (want == s_level) return;
+        setCpuFrequencyMhz(CpuFreq::levelMhz(want));
+        s_level = want;
+        s_switches++;
+    }
+}
+
+namespace CpuFreq {
+
+void begin(bool scaling) {
+    s_mark    = micros();
+    s_scaling = scaling;
+    apply();
+}
+
+void setScaling(bool scaling) {
+    s_scaling = scaling;
+    apply();
+}
+
+void acquire() {
+    s_locks++;
+    apply();
+}
+
+void release() {
+    if (s_locks > 0) s_locks--;
+    apply();
+}
+
+void tick() {
+    account();
+}
+
+uint32_t levelMhz(int level) {
+    return level ? CPU_FREQ_MAX_MHZ : CPU_FREQ_IDLE_MHZ;
+}
+
+uint64_t levelUs(int level) {
+    uint64_t us = s_levelUs[level];
+    if (level == s_level) us += micros() - s_mark;
+    return us;
+}
+
+uint32_t idleMhz()  { return levelMhz(s_scaling ? 0 : 1); }
+uint32_t switches() { return s_switches; }
+
+} // namespace CpuFreq
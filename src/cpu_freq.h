@@ -0,0 +1,56 @@
+#ifndef CPU_FREQ_H
+#define CPU_FREQ_H
+
+#include <stdint.h>
+
+// ============================================
+// Частота CPU по нагрузке
+// ============================================
+// На батарее ядро простаивает на CPU_FREQ_IDLE_MHZ, а работу, которой
+// нужна скорость, оборачивают в блокировку — пока жив хоть один Boost,
+// частота CPU_FREQ_MAX_MHZ:
+//
+//   {
+//       CpuFreq::Boost boost;         // 80 → 160 МГц
+//       handleStats();
+//   }                                 // Последний отпустил — снова 80
+//
+// Boost берут там, где работа точно есть (HTTP-обработчик, отправка
+// WS-кадра, отрисовка кадра OLED), а не вокруг опроса: пустой опрос веб-сервера
+// каждые 10-40 мс стоил бы двух смен частоты.
+//
+// Блокировки считаются (вложенные Boost — одна смена частоты). На USB
+// режим выключен: всегда CPU_FREQ_MAX_MHZ, Boost ничего не переключает.
+//
+// Время на каждой частоте копится с загрузки и отдаётся в /stats.
+// micros() 32-битный и переполняется за ~71 мин, поэтому время
+// досчитывается при каждом acquire()/release() и в tick(), который
+// статистика CPU зовёт каждые STATS_UPDATE_INTERVAL, — без запросов
+// и с погашенным экраном Boost может не браться часами.
+namespace CpuFreq {
+    void begin(bool scaling);
+    void setScaling(bool scaling);   // true — батарея: простой на пониженной
+
+    void acquire();
+    void release();
+    void tick();                     // Досчитать время; чаще раза в ~71 мин
+
+    class Boost {
+    public:
+        Boost()  { acquire(); }
+        ~Boost() { release(); }
+        Boost(const Boost&) = delete;
+        Boost& operator=(const Boost&) = delete;
+    };
+
+    // Уровни: 0 — CPU_FREQ_IDLE_MHZ, 1 — CPU_FREQ_MAX_MHZ
+    static constexpr int LEVELS = 2;
+    uint32_t levelMhz(int level);
+    uint64_t levelUs(int level);     // Включая текущий отрезок
+    // Частота без блокировок. Текущая в /stats бесполезна: ответ сам
+    // собирается под Boost и всегда видит CPU_FREQ_MAX_MHZ
+    uint32_t idleMhz();
+    uint32_t switches();
+}
+
+#endif // CPU_FREQ_H
@@ -1,5 +1,7 @@
 #include "display_manager.h"
+#include "loop_profiler.h"
 #include "calculations.h"
+#include "cpu_freq.h"
 #include <Wire.h>
 
 // CPU usage считается в main.cpp — тот же приём, что в web_server.cpp
@@ -9,6 +11,11 @@ extern float g_cpuUsage;
 static constexpr int CHAR_W = 6;
 static constexpr int CHAR_H = 8;
 
+// update() зовёт планировщик по плановым срокам: если прошлый вызов опоздал,
+// следующий придёт чуть раньше чем через DISPLAY_UPDATE_INTERVAL. Без допуска
+// такой кадр пропускался бы целиком и экран обновлялся бы раз в 2 секунды.
+static constexpr unsigned long UPDATE_SLACK_MS = 50;
+
 DisplayManager::DisplayManager(SensorManager* sensor, WiFiManager* wifi,
                                BatteryManager* battery)
     // clkDuring и clkAfter задаём одинаковыми: библиотека по умолчанию
@@ -152,9 +159,10 @@ void DisplayManager::update() {
         now = millis();
     }
 
-    if (_lastUpdate != 0 && (now - _lastUpdate) < DISPLAY_UPDATE_INTERVAL) return;
+    if (_lastUpdate != 0 && (now - _lastUpdate) + UPDATE_SLACK_MS < DISPLAY_UPDATE_INTERVAL) return;
     _lastUpdate = now;
 
+    CpuFreq::Boost boost;   // Отрисовка в буфер — на CPU (cpu_freq.h)
     _display.clearDisplay();
 
     switch (_screen) {
@@ -305,11 +313,10 @@ void DisplayManager::drawStats() {
         y += 10;
     }
 
-    // Точка росы и heat index — те же формулы, что уходят в веб-интерфейс
-    float t  = _sensor->getTemperature();
-    float h  = _sensor->getHumidity();
-    float dp = WeatherCalculations::calculateDewPoint(t, h);
-    float hi = WeatherCalculations::calculateHeatIndex(t, h);
+    // Точка росы и heat index — те же значения, что уходят в веб-интерфейс
+    // (посчитаны SensorManager один раз на чтение)
+    float dp = _sensor->getDewPoint();
+    float hi = _sensor->getHeatIndex();
 
     _display.setCursor(0, 54);
     _display.print("dew ");
@@ -327,19 +334,32 @@ void DisplayManager::drawSystem() {
 
     _display.setTextSize(1);
 
+    // Шесть строк по 8 px (шрифт 1) под заголовком высотой 10
     if (_wifi->isConnected()) {
-        drawLabeledRow(14, "IP", _wifi->getIP());
-        drawLabeledRow(24, "net", _wifi->getSSID() + " " +
+        drawLabeledRow(12, "IP", _wifi->getIP());
+        drawLabeledRow(20, "net", _wifi->getSSID() + " " +
                                   String(_wifi->getRSSI()) + "dB");
     } else {
-        drawLabeledRow(14, "IP", "—");
-        drawLabeledRow(24, "net", "disconnected");
+        drawLabeledRow(12, "IP", "—");
+        drawLabeledRow(20, "net", "disconnected");
     }
 
-    drawLabeledRow(34, "ram", String(ESP.getFreeHeap() / 1024) + " KB free");
-    drawLabeledRow(44, "cpu", String(g_cpuUsage, 1) + " %  " +
+    drawLabeledRow(28, "ram", String(ESP.getFreeHeap() / 1024) + " KB free");
+    drawLabeledRow(36, "cpu", String(g_cpuUsage, 1) + " %  " +
                               String(ESP.getCpuFreqMHz()) + "MHz");
-    drawLabeledRow(54, "up",  formatUptime());
+
+    // Самая медленная фаза loop() по p99 — виновник задержек
+    LoopPhase slow = LoopProfiler::slowest();
+    LoopProfiler::Summary s = LoopProfiler::summary(slow);
+    char lag[24];
+    if (s.p99Us >= 10000)
+        snprintf(lag, sizeof(lag), "%s %lums", LoopProfiler::name(slow),
+                 (unsigned long)(s.p99Us / 1000));
+    else
+        snprintf(lag, sizeof(lag), "%s %luus", LoopProfiler::name(slow),
+                 (unsigned long)s.p99Us);
+    drawLabeledRow(44, "p99", lag);
+    drawLabeledRow(52, "up",  formatUptime());
 }
 
 // --------------------------------------------
@@ -13,7 +13,7 @@
 enum class DisplayScreen : uint8_t {
     MAIN = 0,   // Крупно температура + влажность
     STATS,      // Min / Max / Avg + точка росы и heat index
-    SYSTEM,     // IP, WiFi, память, CPU, uptime
+    SYSTEM,     // IP, WiFi, память, CPU, p99 самой медленной фазы loop(), uptime
     BATTERY,    // Напряжение, заряд, статус TP4056
     COUNT       // Служебное — количество экранов
 };
@@ -0,0 +1,71 @@
+#include "duty_cycle.h"
+#include "sensor_manager.h"   // packTemp()/packHumid()
+
+namespace {
+    DutyCycleState  s_local;   // Без begin() (тесты) — в RAM
+    DutyCycleState* s_state = &s_local;
+}
+
+namespace DutyCycle {
+
+void begin(DutyCycleState* state) {
+    s_state = state;
+    // Мусор после смены DUTY_CYCLE_BUFFER между прошивками — с нуля
+    if (s_state->head >= DUTY_CYCLE_BUFFER || s_state->count > DUTY_CYCLE_BUFFER) {
+        s_state->head  = 0;
+        s_state->count = 0;
+    }
+}
+
+bool active()          { return s_state->active; }
+void setActive(bool on) { s_state->active = on; }
+
+void wake() {
+    s_state->wakes++;
+    s_state->sinceFlush++;
+}
+
+void append(float temp, float humid) {
+    s_state->samples[s_state->head] = { packTemp(temp), packHumid(humid) };
+    s_state->head = (s_state->head + 1) % DUTY_CYCLE_BUFFER;
+    if (s_state->count < DUTY_CYCLE_BUFFER) s_state->count++;
+    else                                     s_state->dropped++;
+}
+
+bool flushDue() {
+    if (s_state->sinceFlush >= DUTY_CYCLE_FLUSH_EVERY) return true;
+    // Почти полное кольцо торопит сброс — но после неудачного (нет WiFi)
+    // не поднимаем радио на каждом пробуждении: ждём очередного по счёту
+    return !s_state->flushFailed &&
+           s_state->count >= DUTY_CYCLE_BUFFER - DUTY_CYCLE_FLUSH_MARGIN;
+}
+
+void noteAwake(uint32_t us) { s_state->lastAwakeUs = us; }
+
+size_t count() { return s_state->count; }
+
+void sample(size_t i, float& temp, float& humid) {
+    size_t idx = (s_state->head + DUTY_CYCLE_BUFFER - s_state->count + i) % DUTY_CYCLE_BUFFER;
+    temp  = unpackTemp(s_state->samples[idx].temp);
+    humid = unpackHumid(s_state->samples[idx].humid);
+}
+
+void delivered() {
+    if (!s_state->count) return;
+    s_state->count = 0;
+    s_state->flushes++;
+}
+
+void enter() {
+    // Что-то осталось — значит, WiFi в этот раз так и не поднялся
+    s_state->flushFailed = s_state->count > 0;
+    s_state->sinceFlush  = 0;
+    s_state->active      = true;
+}
+
+uint32_t wakes()       { return s_state->wakes; }
+uint32_t flushes()     { return s_state->flushes; }
+uint32_t dropped()     { return s_state->dropped; }
+uint32_t lastAwakeUs() { return s_state->lastAwakeUs; }
+
+} // namespace DutyCycle
@@ -0,0 +1,74 @@
+#ifndef DUTY_CYCLE_H
+#define DUTY_CYCLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// ============================================
+// Duty cycle на батарее: между сбросами — только датчик
+// ============================================
+// Пробуждение по таймеру раз в SENSOR_INTERVAL: батарея, AHT10, сэмпл в
+// RTC-кольцо — и снова deep sleep, без WiFi, дисплея и веб-сервера:
+//
+//   if (wokeFromSleep && DutyCycle::active()) {
+//       DutyCycle::wake();
+//       ...замер...
+//       DutyCycle::append(t, h);
+//       if (!DutyCycle::flushDue()) { DutyCycle::noteAwake(us); /* сон */ }
+//   }
+//
+// Каждое DUTY_CYCLE_FLUSH_EVERY-е пробуждение (или когда в кольце
+// осталось DUTY_CYCLE_FLUSH_MARGIN мест) — полная загрузка: пачка уходит
+// в историю датчика (/history, графики), с подключением WiFi — delivered(),
+// устройство DUTY_CYCLE_AWAKE_MS доступно клиентам, потом enter() и сон.
+//
+// Состояние — DutyCycleState в RTC_DATA_ATTR (main.cpp): переживает deep
+// sleep, после включения питания — нули, т.е. режим выключен.
+
+// Сэмпл в кольце: сотые доли °C / %RH, как PackedSample истории, но без
+// производных — точку росы и heat index посчитает приём чтения при сбросе
+struct DutySample {
+    int16_t  temp;
+    uint16_t humid;
+};
+
+struct DutyCycleState {
+    bool       active;         // Уснули в режиме duty cycle
+    bool       flushFailed;    // Последний сброс прошёл без WiFi
+    uint16_t   head;           // Куда писать следующий
+    uint16_t   count;
+    uint16_t   sinceFlush;     // Пробуждений с последнего сброса
+    uint32_t   wakes;          // Всего пробуждений только ради датчика
+    uint32_t   flushes;        // Удачных сбросов
+    uint32_t   dropped;        // Затёрто при полном кольце
+    uint32_t   lastAwakeUs;    // Сколько длилось последнее такое пробуждение
+    DutySample samples[DUTY_CYCLE_BUFFER];
+};
+
+namespace DutyCycle {
+    void begin(DutyCycleState* state);
+
+    bool active();
+    void setActive(bool on);
+
+    void wake();                              // Пробуждение только ради датчика
+    void append(float temp, float humid);     // Полное кольцо затирает старейший
+    bool flushDue();                          // Пора поднимать WiFi
+    void noteAwake(uint32_t us);
+
+    size_t count();
+    void   sample(size_t i, float& temp, float& humid);   // 0 — самый старый
+    // Пачка влита в историю и WiFi поднят — клиенты её получат; кольцо
+    // очищается. Без WiFi пачка остаётся до следующего сброса
+    void   delivered();
+    // Уходим в сон из полной загрузки: дальше пробуждения только ради датчика
+    void   enter();
+
+    uint32_t wakes();
+    uint32_t flushes();
+    uint32_t dropped();
+    uint32_t lastAwakeUs();
+}
+
+#endif // DUTY_CYCLE_H
@@ -8,7 +8,6 @@ const char HTML_PAGE[] PROGMEM = R"rawliteral(
 <meta charset="UTF-8">
 <meta name="viewport" content="width=device-width,initial-scale=1">
 <title>ENV Station</title>
-<script src="https://cdn.jsdelivr.net/npm/chart.js@3.9.1/dist/chart.min.js"></script>
 <style>
 /* ============ TOKENS — light / purple gradient (default) ============ */
 :root{
@@ -564,7 +563,9 @@ input:checked+.slider:before{transform:translateX(19px)}
 <div class="time-range">
 <button class="tr-btn" onclick="setRange(5,this)">5m</button>
 <button class="tr-btn" onclick="setRange(15,this)">15m</button>
-<button class="tr-btn active" onclick="setRange(0,this)">All</button>
+<button class="tr-btn active" onclick="setRange(0,this)">1h</button>
+<button class="tr-btn" onclick="setRange(0,this,'5m')">48h</button>
+<button class="tr-btn" onclick="setRange(0,this,'1h')">14d</button>
 </div>
 </div>
 <div class="chart-toggles">
@@ -586,7 +587,11 @@ var ws,autoscroll=true,maxLogs=500;
 var activeLogFilters=new Set(['error','warning','info','success']);
 var rawHistory={labels:[],temp:[],humid:[],heat:[],dew:[]};
 var rangeMinutes=0;
+var historyTier='raw'; /* raw = 30s points, 5m / 1h = min/max/mean rollups */
 var SENSOR_SEC=30; /* must match SENSOR_INTERVAL in config.h */
+var RAW_CAP=120; /* must match HISTORY_SIZE in config.h */
+var pushLive=false; /* WS delivers snapshots: HTTP polling is paused */
+var histGen=-1; /* generation of the raw history shown (dedup of pushed points) */
 var sparkCharts={};
 var BLOCK_KEY='envBlockPrefs';
 
@@ -612,11 +617,8 @@ function chartColors(){
 function syncChartTheme(){
   if(!C)return;
   var cc=chartColors();
-  C.options.scales.x.grid.color=cc.grid;
-  C.options.scales.y.grid.color=cc.grid;
-  C.options.scales.x.ticks.color=cc.tick;
-  C.options.scales.y.ticks.color=cc.tick;
-  C.options.scales.y.title.color=cc.tick;
+  C.opt.grid=cc.grid;
+  C.opt.tick=cc.tick;
   C.update();
 }
 
@@ -661,8 +663,10 @@ function initWebSocket(){
     document.getElementById('wsStatus').className='ws-status ws-connected';
     document.getElementById('wsStatusText').textContent='Connected';
     addLog('WebSocket connected','success');
+    updateStats(); /* snapshots carry only per-sample fields; the rest once per connect */
   };
   ws.onclose=function(){
+    pushLive=false; /* back to polling until the socket returns */
     document.getElementById('wsStatus').className='ws-status ws-disconnected';
     document.getElementById('wsStatusText').textContent='Disconnected';
     addLog('WebSocket disconnected, reconnecting...','warning');
@@ -671,19 +675,57 @@ function initWebSocket(){
   ws.onerror=function(){addLog('WebSocket error','error');};
   ws.onmessage=function(e){
     var m=e.data;
-    var t='info';
-    if(/error|fail|err/i.test(m))t='error';
-    else if(/warn|caution/i.test(m))t='warning';
-    else if(/ok|success|done|ready/i.test(m))t='success';
-    addLog(m,t);
-    var tm=m.match(/(?:temp[\s_]?chip|chip[\s_]?temp|cpu[\s_]?temp|internal[\s_]?temp|core[\s_]?temp|t_chip|chip_t)[^\d\-]*(-?[\d.]+)/i);
-    if(!tm)tm=m.match(/^CHIP[:\s]+(-?[\d.]+)/i);
-    if(!tm)tm=m.match(/\bChip:\s*(-?[\d.]+)\s*[CF]?\b/i);
-    if(tm){var v=parseFloat(tm[1]);if(!isNaN(v))updateChipTemp(v);}
-    var rm=m.match(/RAM:\s*([\d.]+)\s*KB\s*free\s*\/\s*([\d.]+)\s*KB\s*\(([\d.]+)%\s*used\)/i);
-    if(rm){updateRamDisplay(parseFloat(rm[1]),parseFloat(rm[2]),parseFloat(rm[3]));}
+    /* Typed snapshots share the socket with plain-text logs */
+    if(m.lastIndexOf('{"t":',0)===0){onPush(JSON.parse(m));return;}
+    /* The firmware batches log lines: one frame per loop pass, '\n'-separated */
+    m.split('\n').forEach(logLine);
   };
 }
+function logLine(m){
+  var t='info';
+  /* Logger lines start with a level letter: "W battery: ..." */
+  var lv=m.match(/^([DIWE]) \w+: /);
+  if(lv&&lv[1]==='E')t='error';
+  else if(lv&&lv[1]==='W')t='warning';
+  else if(/error|fail|err/i.test(m))t='error';
+  else if(/warn|caution/i.test(m))t='warning';
+  else if(/ok|success|done|ready/i.test(m))t='success';
+  addLog(m,t);
+  var tm=m.match(/(?:temp[\s_]?chip|chip[\s_]?temp|cpu[\s_]?temp|internal[\s_]?temp|core[\s_]?temp|t_chip|chip_t)[^\d\-]*(-?[\d.]+)/i);
+  if(!tm)tm=m.match(/^CHIP[:\s]+(-?[\d.]+)/i);
+  if(!tm)tm=m.match(/\bChip:\s*(-?[\d.]+)\s*[CF]?\b/i);
+  if(tm){var v=parseFloat(tm[1]);if(!isNaN(v))updateChipTemp(v);}
+  var rm=m.match(/RAM:\s*([\d.]+)\s*KB\s*free\s*\/\s*([\d.]+)\s*KB\s*\(([\d.]+)%\s*used\)/i);
+  if(rm){updateRamDisplay(parseFloat(rm[1]),parseFloat(rm[2]),parseFloat(rm[3]));}
+}
+
+/* ===== PUSH ===== */
+function onPush(p){
+  if(p.t!=='sample')return;
+  pushLive=true;
+  if(document.hidden)return; /* catch up in one go on visibilitychange */
+  if(p.data)applyData(p.data);
+  if(p.stats)applyStats(p.stats);
+  if(p.point&&historyTier==='raw')appendPoint(p.point);
+}
+function agoLabel(s){ /* same as WeatherWebServer::formatAgo */
+  if(!s)return 'now';
+  if(s<60)return '-'+s+'s';
+  if(s>=7200)return '-'+Math.floor(s/3600)+'h'+(s%3600?Math.floor(s%3600/60)+'m':'');
+  if(s%60===0)return '-'+(s/60)+'m';
+  var t=Math.floor(s/6);
+  return '-'+Math.floor(t/10)+'.'+(t%10)+'m';
+}
+function appendPoint(pt){
+  var h=rawHistory;
+  if(histGen<0||pt.gen<=histGen)return; /* no base yet, or already in /history */
+  histGen=pt.gen;
+  ['temp','humid','dew','heat'].forEach(function(k){h[k].push(pt[k]);});
+  if(h.temp.length>RAW_CAP)['temp','humid','dew','heat'].forEach(function(k){h[k].shift();});
+  else h.labels.unshift(agoLabel(h.labels.length*SENSOR_SEC));
+  renderChart();
+  updateSparklines();
+}
 
 /* ===== LOGS ===== */
 function addLog(msg,type){
@@ -724,6 +766,152 @@ function toggleAutoscroll(){
 }
 
 /* ===== CHARTS ===== */
+/* ===== MINICHART: canvas line chart, replaces Chart.js from CDN =====
+   Draws only what the page needs: the combined 4-series chart (axes,
+   grid, index tooltip, series toggle) and the sparklines. No
+   animation and no external requests, so the first chart draws as soon
+   as /history arrives, even on a network without internet access. */
+var MC_FONT='ui-monospace,Consolas,monospace';
+function MiniChart(cv,opt){
+  var self=this;
+  this.cv=cv;this.ctx=cv.getContext('2d');this.opt=opt;this.hover=-1;
+  this.data={labels:[],datasets:opt.datasets};
+  /* Freeze the CSS height once, otherwise the new width/height attributes
+     would change the canvas aspect ratio and grow it on every resize */
+  cv.style.height=(cv.clientHeight||opt.height||150)+'px';
+  if(opt.tooltip){
+    cv.addEventListener('mousemove',function(e){self.pointer(e.clientX);});
+    cv.addEventListener('touchstart',function(e){self.pointer(e.touches[0].clientX);},{passive:true});
+    cv.addEventListener('mouseleave',function(){self.hover=-1;self.draw();});
+  }
+  if(window.ResizeObserver)new ResizeObserver(function(){self.update();}).observe(cv);
+  else window.addEventListener('resize',function(){self.update();});
+}
+MiniChart.prototype.update=function(){
+  var cv=this.cv,d=window.devicePixelRatio||1,w=cv.clientWidth,h=cv.clientHeight;
+  if(!w||!h)return; /* Block hidden — redraw on the next resize */
+  if(cv.width!==Math.round(w*d)||cv.height!==Math.round(h*d)){cv.width=Math.round(w*d);cv.height=Math.round(h*d);}
+  this.w=w;this.h=h;this.dpr=d;
+  this.draw();
+};
+MiniChart.prototype.count=function(){
+  var n=this.data.labels.length;
+  this.data.datasets.forEach(function(s){if(s.data&&s.data.length>n)n=s.data.length;});
+  return n;
+};
+MiniChart.prototype.layout=function(){
+  var o=this.opt,n=this.count(),lo=Infinity,hi=-Infinity;
+  this.data.datasets.forEach(function(s){
+    if(s.hidden||!s.data)return;
+    s.data.forEach(function(v){if(v!=null&&isFinite(v)){if(v<lo)lo=v;if(v>hi)hi=v;}});
+  });
+  if(lo===Infinity)return null;
+  var L={n:n,l:o.axes?6:1,r:this.w-(o.axes?44:1),t:o.axes?10:3,b:this.h-(o.axes?22:3)};
+  if(o.axes){
+    /* "Nice" steps 1/2/5×10^k, about five ticks */
+    var span=(hi-lo)||1,raw=span/4,p=Math.pow(10,Math.floor(Math.log10(raw))),f=raw/p;
+    L.step=(f<1.5?1:f<3.5?2:f<7.5?5:10)*p;
+    lo=Math.floor(lo/L.step)*L.step;hi=Math.ceil(hi/L.step)*L.step;
+    if(hi===lo)hi=lo+L.step;
+  }else{
+    var pad=(hi-lo)*.1||1;lo-=pad;hi+=pad;
+  }
+  L.lo=lo;L.hi=hi;
+  return L;
+};
+MiniChart.prototype.x=function(L,i){return L.n>1?L.l+i*(L.r-L.l)/(L.n-1):(L.l+L.r)/2;};
+MiniChart.prototype.y=function(L,v){return L.b-(v-L.lo)*(L.b-L.t)/(L.hi-L.lo);};
+MiniChart.prototype.draw=function(){
+  var c=this.ctx,o=this.opt,self=this;
+  if(!this.w)return;
+  c.setTransform(this.dpr,0,0,this.dpr,0,0);
+  c.clearRect(0,0,this.w,this.h);
+  var L=this.layout();
+  if(!L)return;
+  if(o.axes)this.axes(L);
+  this.data.datasets.forEach(function(s){if(!s.hidden&&s.data)self.series(L,s);});
+  if(o.tooltip&&this.hover>=0&&this.hover<L.n)this.tip(L);
+};
+MiniChart.prototype.axes=function(L){
+  var c=this.ctx,o=this.opt,lb=this.data.labels;
+  c.lineWidth=1;c.strokeStyle=o.grid;c.fillStyle=o.tick;
+  c.font='11px '+MC_FONT;c.textAlign='left';c.textBaseline='middle';
+  for(var v=L.lo;v<=L.hi+L.step/2;v+=L.step){
+    var y=Math.round(this.y(L,v))+.5;
+    c.beginPath();c.moveTo(L.l,y);c.lineTo(L.r,y);c.stroke();
+    c.fillText(+v.toFixed(6)+'',L.r+6,y);
+  }
+  if(o.yTitle){c.font='10px '+MC_FONT;c.textAlign='right';c.textBaseline='top';c.fillText(o.yTitle,this.w-2,0);}
+  if(!lb.length)return;
+  /* Up to 8 labels, evenly by index (like Chart.js autoSkip) */
+  var every=Math.max(1,Math.ceil(L.n/8));
+  c.font='10px '+MC_FONT;c.textAlign='center';c.textBaseline='top';
+  for(var i=0;i<L.n;i+=every){
+    var x=Math.round(this.x(L,i))+.5;
+    c.beginPath();c.moveTo(x,L.t);c.lineTo(x,L.b);c.stroke();
+    if(lb[i]!=null)c.fillText(lb[i],Math.min(Math.max(x,L.l+16),L.r-16),L.b+6);
+  }
+};
+MiniChart.prototype.series=function(L,s){
+  /* Smoothing via midpoints (quadratic curves): monotone enough, no
+     overshoot. null (sensor failure) breaks the line. */
+  var c=this.ctx,d=s.data,seg=[],segs=[],i;
+  for(i=0;i<d.length;i++){
+    if(d[i]==null||!isFinite(d[i])){if(seg.length)segs.push(seg);seg=[];continue;}
+    seg.push([this.x(L,i),this.y(L,d[i])]);
+  }
+  if(seg.length)segs.push(seg);
+  c.lineWidth=s.borderWidth||this.opt.lineWidth||2;c.lineJoin='round';
+  segs.forEach(function(p){
+    c.beginPath();c.moveTo(p[0][0],p[0][1]);
+    for(var k=1;k<p.length-1;k++)c.quadraticCurveTo(p[k][0],p[k][1],(p[k][0]+p[k+1][0])/2,(p[k][1]+p[k+1][1])/2);
+    if(p.length>1)c.lineTo(p[p.length-1][0],p[p.length-1][1]);
+    else c.lineTo(p[0][0]+.01,p[0][1]);
+    c.strokeStyle=s.borderColor;c.stroke();
+    if(s.backgroundColor){
+      c.lineTo(p[p.length-1][0],L.b);c.lineTo(p[0][0],L.b);c.closePath();
+      c.fillStyle=s.backgroundColor;c.fill();
+    }
+  });
+};
+MiniChart.prototype.pointer=function(clientX){
+  var L=this.layout();
+  if(!L||!this.w)return;
+  var x=clientX-this.cv.getBoundingClientRect().left;
+  var i=L.n>1?Math.round((x-L.l)/(L.r-L.l)*(L.n-1)):0;
+  i=Math.max(0,Math.min(L.n-1,i));
+  if(i!==this.hover){this.hover=i;this.draw();}
+};
+MiniChart.prototype.tip=function(L){
+  var c=this.ctx,i=this.hover,o=this.opt,x=this.x(L,i),self=this,rows=[];
+  c.strokeStyle=o.grid;c.lineWidth=1;
+  c.beginPath();c.moveTo(Math.round(x)+.5,L.t);c.lineTo(Math.round(x)+.5,L.b);c.stroke();
+  this.data.datasets.forEach(function(s,k){
+    var v=s.data&&s.data[i];
+    if(s.hidden||v==null||!isFinite(v))return;
+    c.fillStyle=s.borderColor;c.beginPath();c.arc(x,self.y(L,v),4,0,7);c.fill();
+    rows.push({c:s.borderColor,t:o.tooltip(s,k,v)});
+  });
+  if(!rows.length)return;
+  var title=this.data.labels[i]!=null?this.data.labels[i]+'':'',w=0,lh=17;
+  c.font='12px '+MC_FONT;
+  w=c.measureText(title).width;
+  rows.forEach(function(r){w=Math.max(w,c.measureText(r.t).width+14);});
+  var bw=w+24,bh=(rows.length+1)*lh+16;
+  var bx=x+12+bw>this.w?x-12-bw:x+12,by=Math.max(L.t,Math.min(L.b-bh,L.t+10));
+  c.fillStyle='rgba(30,26,46,.94)';c.strokeStyle='rgba(255,255,255,.14)';
+  c.beginPath();
+  c.moveTo(bx+8,by);c.arcTo(bx+bw,by,bx+bw,by+bh,8);c.arcTo(bx+bw,by+bh,bx,by+bh,8);
+  c.arcTo(bx,by+bh,bx,by,8);c.arcTo(bx,by,bx+bw,by,8);c.closePath();c.fill();c.stroke();
+  c.textAlign='left';c.textBaseline='middle';c.fillStyle='#fff';
+  c.fillText(title,bx+12,by+8+lh/2);
+  rows.forEach(function(r,k){
+    var ry=by+8+lh*(k+1.5);
+    c.fillStyle=r.c;c.fillRect(bx+12,ry-4,8,8);
+    c.fillStyle='#fff';c.fillText(r.t,bx+26,ry);
+  });
+};
+
 var DS_CFG=[
   {label:'Temperature',border:'#f5576c',bg:'rgba(245,87,108,.12)'},
   {label:'Humidity',   border:'#4facfe',bg:'rgba(79,172,254,.12)'},
@@ -731,52 +919,29 @@ var DS_CFG=[
   {label:'Dew point',  border:'#22b8c8',bg:'rgba(34,184,200,.12)'}
 ];
 function initCharts(){
-  var ctx=document.getElementById('combinedChart').getContext('2d');
   var cc=chartColors();
-  C=new Chart(ctx,{
-    type:'line',
-    data:{labels:[],datasets:DS_CFG.map(function(c){return{
-      label:c.label,data:[],borderColor:c.border,backgroundColor:c.bg,
-      tension:.35,fill:true,borderWidth:2,pointRadius:0,pointHoverRadius:5,
-      pointBackgroundColor:c.border
-    };})},
-    options:{
-      responsive:true,maintainAspectRatio:false,
-      interaction:{mode:'index',intersect:false},
-      plugins:{
-        legend:{display:false},
-        tooltip:{
-          backgroundColor:'rgba(30,26,46,.94)',padding:12,cornerRadius:8,
-          titleFont:{size:12,family:'ui-monospace,Consolas,monospace'},
-          bodyFont:{size:12,family:'ui-monospace,Consolas,monospace'},
-          borderColor:'rgba(255,255,255,.14)',borderWidth:1,
-          callbacks:{
-            label:function(c){var u=['\u00B0C','%','\u00B0C','\u00B0C'];if(F){u=['\u00B0F','%','\u00B0F','\u00B0F'];}return' '+c.dataset.label+': '+c.parsed.y.toFixed(1)+' '+u[c.datasetIndex];}
-          }
-        }
-      },
-      scales:{
-        x:{grid:{color:cc.grid,drawBorder:false},ticks:{font:{size:10,family:'ui-monospace,Consolas,monospace'},maxRotation:0,autoSkip:true,maxTicksLimit:8,color:cc.tick}},
-        y:{position:'right',grid:{drawBorder:false,color:cc.grid},ticks:{font:{size:11,family:'ui-monospace,Consolas,monospace'},color:cc.tick},title:{display:true,text:'\u00B0C / %',color:cc.tick,font:{size:10}}}
-      },
-      animation:{duration:500,easing:'easeOutQuart'}
-    }
+  C=new MiniChart(document.getElementById('combinedChart'),{
+    axes:true,grid:cc.grid,tick:cc.tick,yTitle:'\u00B0C / %',
+    datasets:DS_CFG.map(function(c){return{label:c.label,data:[],borderColor:c.border,backgroundColor:c.bg};}),
+    tooltip:function(s,k,v){var u=F?['\u00B0F','%','\u00B0F','\u00B0F']:['\u00B0C','%','\u00B0C','\u00B0C'];return s.label+': '+v.toFixed(1)+' '+u[k];}
   });
 }
 function toggleSeries(idx,btn){
-  var m=C.getDatasetMeta(idx);
-  m.hidden=!m.hidden;
-  btn.classList.toggle('active',!m.hidden);
+  var s=C.data.datasets[idx];
+  s.hidden=!s.hidden;
+  btn.classList.toggle('active',!s.hidden);
   C.update();
 }
-function setRange(minutes,btn){
+function setRange(minutes,btn,tier){
   rangeMinutes=minutes;
   document.querySelectorAll('.tr-btn').forEach(function(b){b.classList.remove('active');});
   btn.classList.add('active');
+  tier=tier||'raw';
+  if(tier!==historyTier){historyTier=tier;updateHistory();return;}
   renderChart();
 }
 function sliceByRange(arr){
-  if(!rangeMinutes||!arr.length)return arr;
+  if(!rangeMinutes||!arr.length||historyTier!=='raw')return arr;
   var pts=Math.round(rangeMinutes*60/SENSOR_SEC);
   return arr.slice(-Math.min(pts,arr.length));
 }
@@ -788,8 +953,10 @@ function renderChart(){
   C.data.datasets[1].data=sliceByRange(rawHistory.humid);
   C.data.datasets[2].data=c2fA(sliceByRange(rawHistory.heat));
   C.data.datasets[3].data=c2fA(sliceByRange(rawHistory.dew));
-  C.options.scales.y.title.text=F?'\u00B0F / %':'\u00B0C / %';
+  C.opt.yTitle=F?'\u00B0F / %':'\u00B0C / %';
   C.update();
+  /* First-render time from navigation start: performance.getEntriesByName('chart-first-render') */
+  if(!performance.getEntriesByName('chart-first-render').length)performance.mark('chart-first-render');
   document.getElementById('updateTimeCombined').textContent=new Date().toLocaleTimeString();
 }
 
@@ -800,10 +967,9 @@ function initSparklines(){
     var el=document.getElementById(id);
     if(!el)return;
     var c=SPK_DEFAULT[id];
-    sparkCharts[id]=new Chart(el.getContext('2d'),{
-      type:'line',
-      data:{labels:[],datasets:[{data:[],borderColor:c,backgroundColor:hexToRgba(c,.12),borderWidth:1.5,pointRadius:0,tension:.35,fill:true}]},
-      options:{responsive:true,maintainAspectRatio:false,plugins:{legend:{display:false},tooltip:{enabled:false}},scales:{x:{display:false},y:{display:false}},animation:{duration:300},events:[]}
+    sparkCharts[id]=new MiniChart(el,{
+      height:40,
+      datasets:[{data:[],borderColor:c,backgroundColor:hexToRgba(c,.12),borderWidth:1.5}]
     });
   });
 }
@@ -816,9 +982,8 @@ function updateSparklines(){
   pairs.forEach(function(p){
     var sc=sparkCharts[p[0]];
     if(!sc)return;
-    sc.data.labels=p[1].map(function(_,i){return i;});
     sc.data.datasets[0].data=p[1];
-    sc.update('none');
+    sc.update();
   });
 }
 
@@ -864,7 +1029,7 @@ function updateCardColors(tc,h,hc,dc){
     if(sc){
       sc.data.datasets[0].borderColor=m[1];
       sc.data.datasets[0].backgroundColor=hexToRgba(m[1],.12);
-      sc.update('none');
+      sc.update();
     }
   });
 }
@@ -920,30 +1085,7 @@ function getComfort(v,isTemp){
   }
 }
 function updateData(){
-  fetch('/data').then(function(r){return r.json();}).then(function(d){
-    var t=F?c2f(d.temperature):d.temperature;
-    var minT=F?c2f(d.minTemp):d.minTemp,maxT=F?c2f(d.maxTemp):d.maxTemp,avgT=F?c2f(d.avgTemp):d.avgTemp;
-    var dewP=F?c2f(d.dewPoint):d.dewPoint,heatI=F?c2f(d.heatIndex):d.heatIndex;
-    document.getElementById('temperature').textContent=t.toFixed(1);
-    document.getElementById('humidity').textContent=d.humidity.toFixed(1);
-    document.getElementById('minTemp').textContent=minT.toFixed(1);
-    document.getElementById('maxTemp').textContent=maxT.toFixed(1);
-    document.getElementById('avgTemp').textContent=avgT.toFixed(1);
-    document.getElementById('minHumid').textContent=d.minHumid.toFixed(1);
-    document.getElementById('maxHumid').textContent=d.maxHumid.toFixed(1);
-    document.getElementById('avgHumid').textContent=d.avgHumid.toFixed(1);
-    document.getElementById('dewPoint').textContent=dewP.toFixed(1);
-    document.getElementById('heatIndex').textContent=heatI.toFixed(1);
-    updateCardColors(d.temperature,d.humidity,d.heatIndex,d.dewPoint);
-    setWeatherFromData(d.temperature,d.humidity);
-    var tc=getComfort(d.temperature,true),hc=getComfort(d.humidity,false);
-    var te=document.getElementById('tempComfort');te.textContent=tc.t;te.className='comfort-indicator comfort-'+tc.l;
-    var he=document.getElementById('humidComfort');he.textContent=hc.t;he.className='comfort-indicator comfort-'+hc.l;
-    document.getElementById('lastUpdate').textContent=new Date().toLocaleTimeString('ru-RU');
-    errCnt=0;
-    document.getElementById('statusBadge').className='status online';
-    document.getElementById('statusBadge').innerHTML='<div class="status-dot"></div><span>Connected</span>';
-  }).catch(function(){
+  fetch('/data').then(function(r){return r.json();}).then(applyData).catch(function(){
     errCnt++;
     if(errCnt>2){
       document.getElementById('statusBadge').className='status offline';
@@ -951,58 +1093,88 @@ function updateData(){
     }
   });
 }
+function applyData(d){
+  var t=F?c2f(d.temperature):d.temperature;
+  var minT=F?c2f(d.minTemp):d.minTemp,maxT=F?c2f(d.maxTemp):d.maxTemp,avgT=F?c2f(d.avgTemp):d.avgTemp;
+  var dewP=F?c2f(d.dewPoint):d.dewPoint,heatI=F?c2f(d.heatIndex):d.heatIndex;
+  document.getElementById('temperature').textContent=t.toFixed(1);
+  document.getElementById('humidity').textContent=d.humidity.toFixed(1);
+  document.getElementById('minTemp').textContent=minT.toFixed(1);
+  document.getElementById('maxTemp').textContent=maxT.toFixed(1);
+  document.getElementById('avgTemp').textContent=avgT.toFixed(1);
+  document.getElementById('minHumid').textContent=d.minHumid.toFixed(1);
+  document.getElementById('maxHumid').textContent=d.maxHumid.toFixed(1);
+  document.getElementById('avgHumid').textContent=d.avgHumid.toFixed(1);
+  document.getElementById('dewPoint').textContent=dewP.toFixed(1);
+  document.getElementById('heatIndex').textContent=heatI.toFixed(1);
+  updateCardColors(d.temperature,d.humidity,d.heatIndex,d.dewPoint);
+  setWeatherFromData(d.temperature,d.humidity);
+  var tc=getComfort(d.temperature,true),hc=getComfort(d.humidity,false);
+  var te=document.getElementById('tempComfort');te.textContent=tc.t;te.className='comfort-indicator comfort-'+tc.l;
+  var he=document.getElementById('humidComfort');he.textContent=hc.t;he.className='comfort-indicator comfort-'+hc.l;
+  document.getElementById('lastUpdate').textContent=new Date().toLocaleTimeString('ru-RU');
+  errCnt=0;
+  document.getElementById('statusBadge').className='status online';
+  document.getElementById('statusBadge').innerHTML='<div class="status-dot"></div><span>Connected</span>';
+}
 function updateStats(){
-  fetch('/stats').then(function(r){return r.json();}).then(function(d){
-    document.getElementById('uptime').textContent=d.uptime;
-    var usedPct=d.heapUsagePct||0;
-    document.getElementById('freeHeap').textContent=d.freeHeap;
-    document.getElementById('ramUsedPct').textContent=usedPct.toFixed(1)+'% used';
-    document.getElementById('ramFreePct').textContent=(100-usedPct).toFixed(1)+'% free';
-    var bar=document.getElementById('ramBarFill');
-    bar.style.width=usedPct+'%';
-    bar.className='ram-bar-fill '+(usedPct>=80?'ram-high':usedPct>=60?'ram-mid':'ram-ok');
-    document.getElementById('cpuUsage').textContent=d.cpuUsage+'%';
-    if(d.chipTemp!=null&&d.chipTemp>0)updateChipTemp(d.chipTemp);
+  fetch('/stats').then(function(r){return r.json();}).then(applyStats).catch(function(e){console.error(e);});
+}
+function applyStats(d){
+  document.getElementById('uptime').textContent=d.uptime;
+  var usedPct=d.heapUsagePct||0;
+  document.getElementById('freeHeap').textContent=d.freeHeap;
+  document.getElementById('ramUsedPct').textContent=usedPct.toFixed(1)+'% used';
+  document.getElementById('ramFreePct').textContent=(100-usedPct).toFixed(1)+'% free';
+  var bar=document.getElementById('ramBarFill');
+  bar.style.width=usedPct+'%';
+  bar.className='ram-bar-fill '+(usedPct>=80?'ram-high':usedPct>=60?'ram-mid':'ram-ok');
+  document.getElementById('cpuUsage').textContent=d.cpuUsage+'%';
+  if(d.chipTemp!=null&&d.chipTemp>0)updateChipTemp(d.chipTemp);
+  var rv=parseInt(d.rssi);
+  document.getElementById('rssi').textContent=d.rssi+' dBm';
+  updateWifiBars(rv);
+  if('ip' in d){ /* full /stats only, WS snapshots leave these as they are */
     document.getElementById('ssid').textContent=d.ssid||'--';
-    var rv=parseInt(d.rssi);
-    document.getElementById('rssi').textContent=d.rssi+' dBm';
-    updateWifiBars(rv);
     document.getElementById('ipAddr').textContent=d.ip;
-    if(d.battery){
-      var b=d.battery;
-      var pct=Math.max(0,Math.min(100,b.percent));
-      var fill=document.getElementById('batteryFill');
-      var isExternalPower=b.isCharging||b.isUsb||(b.voltage>4.25);
-      if(isExternalPower){
-        fill.style.width='100%';
-        fill.className='battery-fill charging';
-        document.getElementById('batteryPercent').textContent='USB power';
-        var voltTxt=b.voltage+'V';
-        if(b.voltage>4.25)voltTxt=b.voltage+'V (ext)';
-        document.getElementById('batteryVoltage').textContent=voltTxt;
-        document.getElementById('batterySource').textContent=b.isCharging?'Charging':(b.isUsb?'Fully charged':'Direct power');
-      } else {
-        fill.style.width=pct+'%';
-        fill.className='battery-fill '+(b.isCritical?'critical':b.isLow?'low':pct<60?'mid':'good');
-        var pTxt=pct+'%';
-        if(b.isCritical)pTxt=pct+'% \u00B7 CRITICAL';
-        else if(b.isLow)pTxt=pct+'% \u00B7 LOW';
-        document.getElementById('batteryPercent').textContent=pTxt;
-        document.getElementById('batteryVoltage').textContent=b.voltage+'V';
-        document.getElementById('batterySource').textContent=(b.status==='Fully charged')?'Full':b.source;
-      }
+  }
+  if(d.battery){
+    var b=d.battery;
+    var pct=Math.max(0,Math.min(100,b.percent));
+    var fill=document.getElementById('batteryFill');
+    var isExternalPower=b.isCharging||b.isUsb||(b.voltage>4.25);
+    if(isExternalPower){
+      fill.style.width='100%';
+      fill.className='battery-fill charging';
+      document.getElementById('batteryPercent').textContent='USB power';
+      var voltTxt=b.voltage+'V';
+      if(b.voltage>4.25)voltTxt=b.voltage+'V (ext)';
+      document.getElementById('batteryVoltage').textContent=voltTxt;
+      document.getElementById('batterySource').textContent=b.isCharging?'Charging':(b.isUsb?'Fully charged':'Direct power');
+    } else {
+      fill.style.width=pct+'%';
+      fill.className='battery-fill '+(b.isCritical?'critical':b.isLow?'low':pct<60?'mid':'good');
+      var pTxt=pct+'%';
+      if(b.isCritical)pTxt=pct+'% \u00B7 CRITICAL';
+      else if(b.isLow)pTxt=pct+'% \u00B7 LOW';
+      document.getElementById('batteryPercent').textContent=pTxt;
+      document.getElementById('batteryVoltage').textContent=b.voltage+'V';
+      document.getElementById('batterySource').textContent=(b.status==='Fully charged')?'Full':b.source;
     }
-  }).catch(function(e){console.error(e);});
+  }
 }
 function updateHistory(){
-  fetch('/history').then(function(r){return r.json();}).then(function(d){
+  var tier=historyTier;
+  fetch(tier==='raw'?'/history':'/history?tier='+tier).then(function(r){return r.json();}).then(function(d){
+    if(tier!==historyTier)return; /* range switched while in flight */
+    histGen=tier==='raw'?d.gen:-1;
     rawHistory.labels=d.labels;
     rawHistory.temp=d.temp;
     rawHistory.humid=d.humid;
     rawHistory.heat=d.heat||d.temp;
     rawHistory.dew=d.dew||d.temp;
     renderChart();
-    updateSparklines();
+    if(tier==='raw')updateSparklines(); /* sparklines always show the last raw points */
   }).catch(function(e){console.error(e);});
 }
 function resetMinMax(){if(confirm('Reset min/max values?')){fetch('/reset').then(function(){updateData();});}}
@@ -1133,9 +1305,15 @@ document.addEventListener('DOMContentLoaded',function(){
   updateData();
   updateStats();
   updateHistory();
-  iU=setInterval(updateData,10000);
-  iS=setInterval(updateStats,10000);
-  iH=setInterval(updateHistory,15000);
+  /* Polling is the fallback: paused while WS pushes snapshots (rollup
+     tiers are not pushed) and while the tab is hidden */
+  iU=setInterval(function(){if(!pushLive&&!document.hidden)updateData();},10000);
+  iS=setInterval(function(){if(!pushLive&&!document.hidden)updateStats();},10000);
+  iH=setInterval(function(){if(!document.hidden&&(!pushLive||historyTier!=='raw'))updateHistory();},15000);
+  document.addEventListener('visibilitychange',function(){
+    if(document.hidden)return;
+    updateData();updateStats();updateHistory();
+  });
 });
 </script>
 </body>
@@ -0,0 +1,244 @@
+#include "json_writer.h"
+#include <string.h>
+#include <math.h>
+
+JsonWriter::JsonWriter(char* buf, size_t cap, Sink sink, void* ctx)
+    : _buf(buf), _cap(cap), _len(0), _total(0),
+      _sink(sink), _ctx(ctx), _overflow(false),
+      _depth(0), _tooDeep(0), _hasItems(0), _afterKey(false) {
+    if (_buf && _cap) _buf[0] = '\0';
+}
+
+// ============================================
+// Структура
+// ============================================
+void JsonWriter::separator() {
+    if (_afterKey) {
+        _afterKey = false;
+        return;
+    }
+    if (_depth == 0) return;
+    uint16_t bit = (uint16_t)(1u << (_depth - 1));
+    if (_hasItems & bit) put(',');
+    _hasItems |= bit;
+}
+
+void JsonWriter::open(char c) {
+    separator();
+    put(c);
+    if (_depth == MAX_DEPTH) {
+        // Запятые глубже не отследить — текст уже не JSON. Уровень считаем
+        // отдельно, чтобы close() не снял чужой бит _hasItems
+        _tooDeep++;
+        _overflow = true;
+        return;
+    }
+    _depth++;
+    _hasItems &= (uint16_t)~(1u << (_depth - 1));
+}
+
+void JsonWriter::close(char c) {
+    if (_tooDeep > 0)    _tooDeep--;
+    else if (_depth > 0) _depth--;
+    put(c);
+}
+
+JsonWriter& JsonWriter::beginObject() { open('{');  return *this; }
+JsonWriter& JsonWriter::endObject()   { close('}'); return *this; }
+JsonWriter& JsonWriter::beginArray()  { open('[');  return *this; }
+JsonWriter& JsonWriter::endArray()    { close(']'); return *this; }
+
+JsonWriter& JsonWriter::key(const char* k) {
+    str(k);
+    put(':');
+    _afterKey = true;
+    return *this;
+}
+
+// ============================================
+// Значения
+// ============================================
+JsonWriter& JsonWriter::num(long v) {
+    char tmp[24];
+    separator();
+    write(tmp, formatInt(tmp, v));
+    return *this;
+}
+
+JsonWriter& JsonWriter::num(unsigned long v) {
+    char tmp[24];
+    size_t n = 0;
+    do {
+        tmp[sizeof(tmp) - 1 - n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    separator();
+    write(tmp + sizeof(tmp) - n, n);
+    return *this;
+}
+
+JsonWriter& JsonWriter::fixed(float v, uint8_t decimals) {
+    separator();
+    if (isnan(v) || isinf(v)) {
+        write("null", 4);
+        return *this;
+    }
+    char tmp[24];
+    write(tmp, formatFixed(tmp, v, decimals));
+    return *this;
+}
+
+JsonWriter& JsonWriter::centi(int32_t v100, uint8_t decimals) {
+    char tmp[24];
+    separator();
+    write(tmp, formatCenti(tmp, v100, decimals));
+    return *this;
+}
+
+JsonWriter& JsonWriter::str(const char* s) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    separator();
+    put('"');
+    if (s) {
+        // Копируем кусками между спецсимволами, а не по байту
+        const char* run = s;
+        for (; *s; s++) {
+            unsigned char c = (unsigned char)*s;
+            if (c >= 0x20 && c != '"' && c != '\\') continue;
+            write(run, (size_t)(s - run));
+            run = s + 1;
+            if (c == '"' || c == '\\') {
+                put('\\');
+                put((char)c);
+            } else if (c == '\n') {
+                write("\\n", 2);
+            } else {
+                char esc[6] = { '\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0xF] };
+                write(esc, sizeof(esc));
+            }
+        }
+        write(run, (size_t)(s - run));
+    }
+    put('"');
+    return *this;
+}
+
+JsonWriter& JsonWriter::boolean(bool v) {
+    separator();
+    if (v) write("true", 4);
+    else   write("false", 5);
+    return *this;
+}
+
+JsonWriter& JsonWriter::raw(const char* json, size_t len) {
+    // Без проверки: вызывающий отвечает за то, что это одно JSON-значение
+    separator();
+    write(json, len);
+    return *this;
+}
+
+// ============================================
+// Форматирование чисел (только целая арифметика)
+// ============================================
+size_t JsonWriter::formatInt(char* out, long v) {
+    char tmp[24];
+    size_t n = 0;
+    unsigned long u = v < 0 ? 0UL - (unsigned long)v : (unsigned long)v;
+    do {
+        tmp[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    size_t len = 0;
+    if (v < 0) out[len++] = '-';
+    while (n) out[len++] = tmp[--n];
+    out[len] = '\0';
+    return len;
+}
+
+size_t JsonWriter::formatFixed(char* out, float v, uint8_t decimals) {
+    static const int32_t POW10[] = { 1, 10, 100, 1000, 10000 };
+    if (decimals > 4) decimals = 4;
+
+    // Единственная float-операция: масштабирование с округлением.
+    // Дальше — целые. Значения за пределами int32 прижимаются.
+    float scaledF = v * POW10[decimals];
+    if (scaledF >  2.0e9f) scaledF =  2.0e9f;
+    if (scaledF < -2.0e9f) scaledF = -2.0e9f;
+    int32_t scaled = (int32_t)lroundf(scaledF);
+
+    if (decimals == 0) return formatInt(out, scaled);
+
+    size_t len = 0;
+    if (scaled < 0) {
+        out[len++] = '-';
+        scaled = -scaled;
+    }
+    len += formatInt(out + len, scaled / POW10[decimals]);
+    out[len++] = '.';
+    int32_t frac = scaled % POW10[decimals];
+    for (int d = decimals - 1; d >= 0; d--) {
+        out[len + d] = (char)('0' + frac % 10);
+        frac /= 10;
+    }
+    len += decimals;
+    out[len] = '\0';
+    return len;
+}
+
+size_t JsonWriter::formatCenti(char* out, int32_t v100, uint8_t decimals) {
+    if (decimals > 2) decimals = 2;
+
+    size_t len = 0;
+    uint32_t u = v100 < 0 ? (uint32_t)(-(int64_t)v100) : (uint32_t)v100;
+    // Округление до нужного числа знаков (половина — от нуля)
+    if (decimals == 1) u = (u + 5) / 10;
+    else if (decimals == 0) u = (u + 50) / 100;
+    if (v100 < 0 && u != 0) out[len++] = '-';
+
+    uint32_t div = decimals == 2 ? 100 : (decimals == 1 ? 10 : 1);
+    len += formatInt(out + len, (long)(u / div));
+    if (decimals == 0) return len;
+
+    out[len++] = '.';
+    uint32_t frac = u % div;
+    if (decimals == 2) out[len++] = (char)('0' + frac / 10);
+    out[len++] = (char)('0' + frac % 10);
+    out[len] = '\0';
+    return len;
+}
+
+// ============================================
+// Вывод
+// ============================================
+void JsonWriter::put(char c) {
+    write(&c, 1);
+}
+
+void JsonWriter::write(const char* s, size_t n) {
+    _total += n;
+    while (n) {
+        // Последний байт буфера держим под '\0' — c_str() всегда валиден
+        size_t room = _cap > _len + 1 ? _cap - _len - 1 : 0;
+        if (room == 0) {
+            if (!_sink || _len == 0) {
+                _overflow = true;
+                return;
+            }
+            flush();
+            continue;
+        }
+        size_t chunk = n < room ? n : room;
+        memcpy(_buf + _len, s, chunk);
+        _len += chunk;
+        s    += chunk;
+        n    -= chunk;
+        _buf[_len] = '\0';
+    }
+}
+
+void JsonWriter::flush() {
+    if (!_sink || _len == 0) return;
+    _sink(_ctx, _buf, _len);
+    _len = 0;
+    _buf[0] = '\0';
+}
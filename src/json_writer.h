@@ -0,0 +1,98 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================
+// JSON без кучи
+// ============================================
+// Пишет прямо в буфер вызывающего (обычно на стеке обработчика): ни одного
+// String, ни одного malloc. Числа с плавающей точкой форматируются через
+// целые (значение × 10^decimals), без dtostrf/printf("%f") — на C3 нет FPU,
+// и soft-float printf тяжёлый.
+//
+// Запятые между элементами расставляются сами:
+//
+//   char buf[256];
+//   JsonWriter w(buf, sizeof(buf));
+//   w.beginObject();
+//   w.key("temperature").fixed(23.456f, 2);   // "temperature":23.46
+//   w.key("labels").beginArray();
+//   w.str("now");
+//   w.endArray();
+//   w.endObject();
+//   _server.send_P(200, "application/json", buf, w.length());
+//
+// Если задан sink, заполненный буфер сливается в него и переиспользуется —
+// так ответ любой длины проходит через буфер фиксированного размера.
+// Без sink лишнее отбрасывается и поднимается overflow(); он же — при
+// вложенности глубже MAX_DEPTH.
+class JsonWriter {
+public:
+    typedef void (*Sink)(void* ctx, const char* data, size_t len);
+
+    JsonWriter(char* buf, size_t cap, Sink sink = nullptr, void* ctx = nullptr);
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+
+    // Ключ объекта; следующее значение пишется без запятой
+    JsonWriter& key(const char* k);
+
+    // int32_t — это long на RISC-V и int на хосте, поэтому перегрузки
+    // по базовым типам, а не по int32_t/uint32_t
+    JsonWriter& num(long v);
+    JsonWriter& num(unsigned long v);
+    JsonWriter& num(int v)      { return num((long)v); }
+    JsonWriter& num(unsigned v) { return num((unsigned long)v); }
+    JsonWriter& fixed(float v, uint8_t decimals);        // NaN/inf → null
+    JsonWriter& centi(int32_t v100, uint8_t decimals);   // Значение в сотых, decimals ≤ 2
+    JsonWriter& str(const char* s);                      // С экранированием
+    JsonWriter& boolean(bool v);
+    JsonWriter& raw(const char* json, size_t len);       // Готовый JSON как значение
+
+    // Слить остаток в sink (для режима без sink ничего не делает)
+    void flush();
+
+    // Режим без sink: текст в буфере (всегда с '\0' в конце)
+    const char* c_str() const { return _buf; }
+    size_t length() const     { return _len; }
+    bool   overflow() const   { return _overflow; }
+
+    // Сколько байт записано всего, включая уже слитые в sink
+    size_t total() const      { return _total; }
+
+    // Форматирование без записи: текст числа в out (cap ≥ 24), возвращает длину
+    static size_t formatInt(char* out, long v);
+    static size_t formatFixed(char* out, float v, uint8_t decimals);
+    static size_t formatCenti(char* out, int32_t v100, uint8_t decimals);
+
+private:
+    static constexpr int MAX_DEPTH = 8;
+
+    char*  _buf;
+    size_t _cap;
+    size_t _len;
+    size_t _total;
+    Sink   _sink;
+    void*  _ctx;
+    bool   _overflow;
+
+    // Бит на уровень вложенности: 1 = в контейнере уже есть элемент.
+    // Уровни глубже MAX_DEPTH — только счётчик (и overflow())
+    uint8_t  _depth;
+    uint8_t  _tooDeep;
+    uint16_t _hasItems;
+    bool     _afterKey;
+
+    void separator();
+    void open(char c);
+    void close(char c);
+    void put(char c);
+    void write(const char* s, size_t n);
+};
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,138 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================
+// Кольцевой буфер строк лога с несколькими читателями
+// ============================================
+// Один общий буфер на всех WebSocket-клиентов; очередь клиента — это его
+// курсор (Reader) в буфере. Запись никогда не ждёт читателей: если места
+// нет, затираются самые старые строки, а отставший читатель при следующем
+// чтении перескакивает вперёд и получает число потерянных строк.
+//
+//   LogRing<2048> ring;
+//   LogRing<2048>::Reader r = ring.reader();   // Только новые строки
+//   LogRing<2048>::Reader h = ring.reader(1024); // + последний 1 КБ истории
+//   ring.append("T: 23.1C", 8);
+//   char frame[256];
+//   uint32_t dropped;
+//   size_t n = ring.peek(r, frame, sizeof(frame), dropped);   // "T: 23.1C\n"
+//   if (n && send(frame, n)) ring.commit(r, n);
+//
+// Позиции — абсолютные счётчики байт и строк (uint32_t): переполнение
+// наступит через 4 ГБ лога, разности при этом всё равно верны.
+template <size_t N>
+class LogRing {
+    // pos % N не прыгает при переполнении uint32_t, только если N делит 2^32
+    static_assert(N > 0 && (N & (N - 1)) == 0, "LogRing size must be a power of two");
+
+public:
+    struct Reader {
+        uint32_t pos  = 0;   // Абсолютная позиция в байтах
+        uint32_t line = 0;   // Абсолютный номер строки
+    };
+
+    // Строка длиннее этого обрезается, чтобы не вытеснить весь буфер разом
+    static constexpr size_t MAX_LINE = N / 4;
+
+    // Читатель, которому видны только строки, добавленные после этого вызова
+    Reader reader() const { return { _head, _headLine }; }
+
+    // Читатель с историей: последние строки, целиком влезающие в backlog байт
+    Reader reader(size_t backlog) const {
+        Reader r = { _tail, _tailLine };
+        if (_head - _tail <= backlog) return r;
+        // Граница backlog попала внутрь строки — начинаем со следующей целой
+        uint32_t from = _head - backlog;
+        while (r.pos != from) {
+            if (atc(r.pos) == '\n') r.line++;
+            r.pos++;
+        }
+        if (atc(r.pos - 1) != '\n') {
+            while (atc(r.pos) != '\n') r.pos++;
+            r.pos++;
+            r.line++;
+        }
+        return r;
+    }
+
+    void append(const char* s, size_t len) {
+        if (len > MAX_LINE) len = MAX_LINE;
+        size_t need = len + 1;   // + '\n'
+        while (_head - _tail + need > N) dropOldest();
+        for (size_t i = 0; i < len; i++) at(_head + i) = s[i];
+        at(_head + len) = '\n';
+        _head += need;
+        _headLine++;
+    }
+
+    // Скопировать в out целые строки от курсора, каждую с '\n' на конце.
+    // Курсор не двигается — это делает commit() после успешной отправки.
+    // dropped — сколько строк читатель потерял (их затёрли раньше, чем прочли).
+    size_t peek(Reader& r, char* out, size_t cap, uint32_t& dropped) const {
+        dropped = 0;
+        if ((int32_t)(r.pos - _tail) < 0) {
+            dropped = _tailLine - r.line;
+            r.pos   = _tail;
+            r.line  = _tailLine;
+        }
+        size_t n = 0;
+        uint32_t p = r.pos;
+        while (p != _head) {
+            uint32_t e = p;
+            while (atc(e) != '\n') e++;
+            size_t lineLen = e - p + 1;
+            if (n + lineLen > cap) {
+                // Первая же строка не влезает (cap < MAX_LINE) — отдаём её обрезанной,
+                // иначе читатель застрянет на ней навсегда
+                if (n == 0) {
+                    for (size_t i = 0; i < cap; i++) out[i] = atc(p + i);
+                    return cap;
+                }
+                break;
+            }
+            for (size_t i = 0; i < lineLen; i++) out[n + i] = atc(p + i);
+            n += lineLen;
+            p += lineLen;
+        }
+        return n;
+    }
+
+    // Продвинуть курсор за n байт, отданных последним peek().
+    // Строки считаются по самому кольцу — кадр вызывающий волен менять.
+    void commit(Reader& r, size_t n) const {
+        for (size_t i = 0; i < n; i++) if (atc(r.pos + i) == '\n') r.line++;
+        r.pos += n;
+        if (n && atc(r.pos - 1) != '\n') {
+            // Строка ушла обрезанной — её хвост пропускаем
+            while (atc(r.pos) != '\n') r.pos++;
+            r.pos++;
+            r.line++;
+        }
+    }
+
+    bool pending(const Reader& r) const { return r.pos != _head; }
+
+    uint32_t lines() const   { return _headLine; }   // Всего добавлено
+    uint32_t evicted() const { return _tailLine; }   // Вытеснено из буфера
+
+private:
+    char     _buf[N];
+    uint32_t _head     = 0;
+    uint32_t _tail     = 0;
+    uint32_t _headLine = 0;
+    uint32_t _tailLine = 0;
+
+    char&       at(uint32_t pos)        { return _buf[pos % N]; }
+    const char& atc(uint32_t pos) const { return _buf[pos % N]; }
+
+    void dropOldest() {
+        while (atc(_tail) != '\n') _tail++;
+        _tail++;
+        _tailLine++;
+    }
+};
+
+#endif // LOG_RING_H
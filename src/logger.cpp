@@ -0,0 +1,47 @@
+#include "logger.h"
+#include "alloc_counter.h"
+#include <Arduino.h>
+#include <stdarg.h>
+
+namespace {
+    char         s_line[LOG_LINE_SIZE];
+    Logger::Sink s_sink    = nullptr;
+    void*        s_sinkCtx = nullptr;
+    uint32_t     s_lines   = 0;
+    uint32_t     s_allocs  = 0;
+}
+
+namespace Logger {
+
+void setSink(Sink sink, void* ctx) {
+    s_sink    = sink;
+    s_sinkCtx = ctx;
+}
+
+void write(LogLevel level, const char* tag, const char* fmt, ...) {
+    uint32_t allocs0 = AllocCounter::count();
+
+    static const char LEVELS[] = "DIWE";
+    int n = snprintf(s_line, sizeof(s_line), "%c %s: ", LEVELS[(int)level], tag);
+
+    va_list args;
+    va_start(args, fmt);
+    int m = vsnprintf(s_line + n, sizeof(s_line) - n, fmt, args);
+    va_end(args);
+
+    // Длинная строка обрезается по буферу — vsnprintf вернул бы полную длину
+    size_t len = (size_t)n + (m > 0 ? (size_t)m : 0);
+    if (len > sizeof(s_line) - 1) len = sizeof(s_line) - 1;
+
+    Serial.write(reinterpret_cast<const uint8_t*>(s_line), len);
+    Serial.println();
+    if (s_sink) s_sink(s_sinkCtx, s_line, len);
+
+    s_lines++;
+    s_allocs = AllocCounter::count() - allocs0;
+}
+
+uint32_t lines()  { return s_lines; }
+uint32_t allocs() { return s_allocs; }
+
+} // namespace Logger
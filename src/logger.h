@@ -0,0 +1,46 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// ============================================
+// Лог без кучи
+// ============================================
+// printf-формат с уровнем и тегом подсистемы. Строка собирается один раз
+// в статический буфер и уходит в Serial и в sink (WS-кольцо веб-сервера) —
+// без единого String:
+//
+//   LOG_I("sensor", "T: %.1fC | H: %.1f%%", t, h);   // "I sensor: T: 22.0C | H: 45.0%"
+//   LOG_W("battery", "Low battery: %.2fV", v);        // "W battery: Low battery: 3.41V"
+//
+// Первая буква — уровень (D/I/W/E): по ней дашборд красит строку.
+// Вызовы уровнем ниже LOG_MIN_LEVEL (config.h) — константное if(false):
+// компилятор выбрасывает их целиком, аргументы не вычисляются.
+//
+// Вызывать только из loop-задачи: буфер один на всех.
+enum class LogLevel : uint8_t { DEBUG, INFO, WARN, ERROR };
+
+#define LOG_AT(level, tag, ...) \
+    do { if ((int)(level) >= LOG_MIN_LEVEL) Logger::write((level), (tag), __VA_ARGS__); } while (0)
+
+#define LOG_D(tag, ...) LOG_AT(LogLevel::DEBUG, tag, __VA_ARGS__)
+#define LOG_I(tag, ...) LOG_AT(LogLevel::INFO,  tag, __VA_ARGS__)
+#define LOG_W(tag, ...) LOG_AT(LogLevel::WARN,  tag, __VA_ARGS__)
+#define LOG_E(tag, ...) LOG_AT(LogLevel::ERROR, tag, __VA_ARGS__)
+
+namespace Logger {
+    typedef void (*Sink)(void* ctx, const char* line, size_t len);
+
+    // Куда, кроме Serial, отдавать готовую строку (без '\n')
+    void setSink(Sink sink, void* ctx);
+
+    void write(LogLevel level, const char* tag, const char* fmt, ...)
+        __attribute__((format(printf, 3, 4)));
+
+    uint32_t lines();     // Строк записано
+    uint32_t allocs();    // malloc в последнем write() (с ALLOC_COUNTER; ожидается 0)
+}
+
+#endif // LOGGER_H
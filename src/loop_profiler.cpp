@@ -0,0 +1,141 @@
+#include "loop_profiler.h"
+#include "config.h"
+#include <Arduino.h>
+
+namespace {
+    constexpr int SUB     = 4;                 // Корзин на октаву
+    constexpr int OCTAVES = 24;                // До 2^24 мкс ≈ 16 с
+    constexpr int BUCKETS = (OCTAVES - 1) * SUB;
+    constexpr int PHASES  = (int)LoopPhase::COUNT;
+
+    struct Histogram {
+        uint32_t buckets[BUCKETS];
+        uint32_t count;
+        uint32_t minUs;
+        uint32_t maxUs;
+    };
+
+    Histogram     s_hist[PHASES];
+    unsigned long s_mark      = 0;
+    unsigned long s_loopStart = 0;
+    uint32_t      s_passUs[PHASES];   // Фазы текущего прохода
+
+    LoopProfiler::Stall s_stalls[LOOP_STALL_HISTORY];
+    size_t              s_stallNext  = 0;
+    uint32_t            s_stallCount = 0;
+
+    int bucketOf(uint32_t us) {
+        if (us < SUB) return (int)us;
+        int msb = 31 - __builtin_clz(us);
+        int b   = (msb - 1) * SUB + (int)((us >> (msb - 2)) & (SUB - 1));
+        return b < BUCKETS ? b : BUCKETS - 1;
+    }
+
+    uint32_t upperBound(int b) {
+        if (b < SUB) return (uint32_t)b;
+        int msb = b / SUB + 1;
+        int sub = b % SUB;
+        return ((uint32_t)(SUB + sub + 1) << (msb - 2)) - 1;
+    }
+
+    uint32_t percentile(const Histogram& h, uint32_t permille) {
+        uint64_t target = (uint64_t)h.count * permille / 1000, acc = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            acc += h.buckets[b];
+            if (acc > target) return upperBound(b) < h.maxUs ? upperBound(b) : h.maxUs;
+        }
+        return h.maxUs;
+    }
+}
+
+namespace LoopProfiler {
+
+void beginLoop() {
+    s_mark = s_loopStart = micros();
+    memset(s_passUs, 0, sizeof(s_passUs));
+}
+
+void lap(LoopPhase phase) {
+    unsigned long now = micros();
+    uint32_t us = now - s_mark;
+    s_mark = now;
+    s_passUs[(int)phase] += us;
+
+    Histogram& h = s_hist[(int)phase];
+    h.buckets[bucketOf(us)]++;
+    if (h.count == 0 || us < h.minUs) h.minUs = us;
+    if (us > h.maxUs) h.maxUs = us;
+    h.count++;
+}
+
+Stall* endLoop() {
+    uint32_t total = micros() - s_loopStart;
+    if (total < LOOP_STALL_THRESHOLD_MS * 1000UL) return nullptr;
+
+    int worst = 0;
+    for (int i = 1; i < PHASES; i++)
+        if (s_passUs[i] > s_passUs[worst]) worst = i;
+
+    Stall& s = s_stalls[s_stallNext];
+    s_stallNext = (s_stallNext + 1) % LOOP_STALL_HISTORY;
+    s_stallCount++;
+
+    s = Stall();
+    s.atMs    = millis();
+    s.totalUs = total;
+    s.phaseUs = s_passUs[worst];
+    s.phase   = (LoopPhase)worst;
+    s.wifi    = "";
+    return &s;
+}
+
+void reset() {
+    memset(s_hist, 0, sizeof(s_hist));
+    s_stallNext  = 0;
+    s_stallCount = 0;
+}
+
+uint32_t stallCount() {
+    return s_stallCount;
+}
+
+size_t recentStalls() {
+    return s_stallCount < (uint32_t)LOOP_STALL_HISTORY ? s_stallCount : LOOP_STALL_HISTORY;
+}
+
+const Stall& stall(size_t i) {
+    return s_stalls[(s_stallNext + LOOP_STALL_HISTORY - 1 - i) % LOOP_STALL_HISTORY];
+}
+
+Summary summary(LoopPhase phase) {
+    const Histogram& h = s_hist[(int)phase];
+    return { h.count, h.minUs, percentile(h, 500), percentile(h, 990), h.maxUs };
+}
+
+const char* name(LoopPhase phase) {
+    switch (phase) {
+        case LoopPhase::BUTTON:  return "button";
+        case LoopPhase::BATTERY: return "battery";
+        case LoopPhase::WIFI:    return "wifi";
+        case LoopPhase::WEB:     return "web";
+        case LoopPhase::DISPLAY: return "display";
+        case LoopPhase::SENSOR:  return "sensor";
+        case LoopPhase::STATUS:  return "status";
+        default:                 return "?";
+    }
+}
+
+LoopPhase slowest() {
+    LoopPhase worst = LoopPhase::BUTTON;
+    uint32_t  worstUs = 0;
+    for (int i = 0; i < PHASES; i++) {
+        uint32_t p99 = percentile(s_hist[i], 990);
+        if (p99 > worstUs) {
+            worstUs = p99;
+            worst   = (LoopPhase)i;
+        }
+    }
+    return worst;
+}
+
+} // namespace LoopProfiler
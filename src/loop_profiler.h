@@ -0,0 +1,75 @@
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================
+// Профиль прохода loop() по фазам
+// ============================================
+// Каждый запуск задачи планировщика пишет своё время в гистограмму своей
+// фазы: октавы по 4 линейные корзины (граница перцентиля завышена не больше
+// чем на 25%), до 16 с. Отметки ставятся "кругами", без вложенных скобок —
+// Scheduler::runDue() делает это сам после каждой задачи:
+//
+//   LoopProfiler::beginLoop();
+//   button.poll();               LoopProfiler::lap(LoopPhase::BUTTON);
+//   webServer.handleClient();    LoopProfiler::lap(LoopPhase::WEB);
+//
+// lap() берёт время от предыдущей отметки — код между фазами не теряется.
+// Фаза, чей срок в этом проходе не наступил, в гистограмму не попадает:
+// перцентили — это цена реального запуска, а не "пустых" тиков.
+// Копится с загрузки; /reset обнуляет вместе с min/max датчика.
+//
+// endLoop() — детектор зависаний: проход дольше LOOP_STALL_THRESHOLD_MS
+// записывается в кольцо из LOOP_STALL_HISTORY последних с самой долгой
+// фазой. Состояние вокруг (клиенты, WiFi) дописывает вызывающий:
+//
+//   if (LoopProfiler::Stall* s = LoopProfiler::endLoop()) {
+//       s->wsClients = webServer.getClientCount();
+//       s->wifi      = wifiManager.getStatusName();
+//   }
+enum class LoopPhase : uint8_t {
+    BUTTON,    // button.poll() и реакция на нажатие
+    BATTERY,   // batteryManager.update() + проверка на сон
+    WIFI,      // checkConnection()
+    WEB,       // handleClient(): HTTP + WebSocket + сброс лога
+    DISPLAY,   // displayManager.update()
+    SENSOR,    // запуск/опрос AHT10, лог чтения, WS-снимок
+    STATUS,    // updateCPUUsage() + printStatus()
+    COUNT
+};
+
+namespace LoopProfiler {
+    struct Summary {
+        uint32_t count;
+        uint32_t minUs;
+        uint32_t p50Us;
+        uint32_t p99Us;
+        uint32_t maxUs;
+    };
+
+    struct Stall {
+        uint32_t    atMs;        // millis() в конце прохода
+        uint32_t    totalUs;     // Весь проход
+        uint32_t    phaseUs;     // Из них — самая долгая фаза
+        LoopPhase   phase;
+        uint8_t     wsClients;   // Дальше — заполняет вызывающий
+        const char* wifi;        // Строка со статическим временем жизни
+    };
+
+    void   beginLoop();
+    void   lap(LoopPhase phase);
+    Stall* endLoop();            // nullptr — проход уложился в порог
+    void   reset();
+
+    uint32_t     stallCount();             // Всего с загрузки (или /reset)
+    size_t       recentStalls();           // Сколько в кольце
+    const Stall& stall(size_t i);          // 0 — самое свежее
+
+    Summary     summary(LoopPhase phase);
+    const char* name(LoopPhase phase);   // "button", "web", ...
+    LoopPhase   slowest();               // Фаза с наибольшим p99
+}
+
+#endif // LOOP_PROFILER_H
@@ -1,5 +1,6 @@
 #include <Arduino.h>
 #include <esp_sleep.h>
+#include <esp_system.h>
 #include <Wire.h>
 #include "config.h"
 #include "wifi_manager.h"
@@ -9,6 +10,12 @@
 #include "calculations.h"
 #include "display_manager.h"
 #include "button.h"
+#include "logger.h"
+#include "loop_profiler.h"
+#include "scheduler.h"
+#include "cpu_freq.h"
+#include "boot_timeline.h"
+#include "duty_cycle.h"
 
 // ============================================
 // Global variables
@@ -20,37 +27,35 @@ float g_cpuUsage = 0.0;
 // Используется для прогрессивного увеличения длительности сна: 5→10→20→40→60 мин.
 RTC_DATA_ATTR uint32_t g_sleepCycles = 0;
 RTC_DATA_ATTR uint32_t g_bootCount   = 0;
+// Последняя удачная AP: после сна подключаемся без скана (см. WiFiCache)
+RTC_DATA_ATTR WiFiCache g_wifiCache  = {};
+// Этапы последних загрузок — переживают и программный сброс (см. BootHistory)
+RTC_NOINIT_ATTR BootHistory g_bootHistory;
+// Duty cycle: режим и пачка замеров между сбросами (см. duty_cycle.h)
+RTC_DATA_ATTR DutyCycleState g_dutyCycle = {};
 
 // Objects
-WiFiManager wifiManager(WIFI_SSID, WIFI_PASSWORD);
+WiFiManager wifiManager(WIFI_SSID, WIFI_PASSWORD, &g_wifiCache);
 SensorManager sensorManager;
 BatteryManager batteryManager(BATTERY_ADC_PIN, BATTERY_CHRG_PIN, BATTERY_STDBY_PIN);
 WeatherWebServer webServer(&sensorManager, &wifiManager, &batteryManager);
 DisplayManager displayManager(&sensorManager, &wifiManager, &batteryManager);
 ButtonManager button(BUTTON_PIN);
 
-// Timers
-unsigned long lastSensorRead = 0;
-// lastWiFiCheck удалён — checkConnection() теперь вызывается каждый тик (не блокирует)
-unsigned long lastStatsUpdate = 0;
-unsigned long lastBatteryCheck = 0;
+// Периодические задачи вместо таймеров lastXxx — см. registerTasks()
+Scheduler scheduler;
+int buttonTaskId     = -1;   // Пробуждение кнопкой — опросить сразу
+int webTaskId        = -1;   // Период зависит от питания
+int displayTaskId    = -1;   // Кнопка просит перерисовку немедленно
+int wifiTaskId       = -1;   // Частый опрос до первого подключения
+int sensorPollTaskId = -1;   // Разовая: взводится после триггера AHT10
+int dutyTaskId       = -1;   // Разовая: конец окна сброса duty cycle
 unsigned long systemStartTime = 0;
 
 // CPU monitoring
-unsigned long lastCpuCheck = 0;
 unsigned long idleTime = 0;
 unsigned long busyTime = 0;
 
-// ============================================
-// Helper: Dual logging (Serial + WebSocket)
-// ============================================
-void logBoth(const String& message) {
-    Serial.println(message);
-    if (wifiManager.isConnected()) {
-        webServer.broadcastLog(message);
-    }
-}
-
 // ============================================
 // Deep Sleep Management
 // ============================================
@@ -69,10 +74,9 @@ void enterDeepSleep(uint64_t duration_us, const char* reason) {
     // Отправляем уведомление через WebSocket.
     // БАГФИКС: раньше был просто delay(500) — но без вызова wsServer.loop()
     // сообщение могло не уйти. Прокачиваем обработчик клиентов ~500 мс.
+    LOG_W("power", "⚠️ DEEP SLEEP: %s", reason);
+    LOG_I("power", "Duration: %lus", (unsigned long)(duration_us / 1000000ULL));
     if (wifiManager.isConnected()) {
-        String msg = "⚠️ DEEP SLEEP: " + String(reason);
-        webServer.broadcastLog(msg);
-        webServer.broadcastLog("Duration: " + String((unsigned long)(duration_us / 1000000ULL)) + "s");
         unsigned long t0 = millis();
         while (millis() - t0 < 500) {
             webServer.handleClient();
@@ -138,6 +142,70 @@ void checkBatteryAndSleep() {
     }
 }
 
+// ============================================
+// Duty cycle (duty_cycle.h)
+// ============================================
+// Докуда sensorOnlyWake() успел поднять железо — setup() это не повторяет
+enum class EarlyInit : uint8_t {
+    NONE,       // Обычная загрузка
+    BATTERY,    // Serial и батарея
+    BUS,        // ...и шина I2C
+    SENSOR      // ...и AHT10; свежий замер — последний в RTC-кольце
+};
+
+// Пробуждение только ради датчика: батарея, AHT10, сэмпл в RTC-кольцо и
+// обратно в сон. Без ожидания Serial, WiFi, дисплея и веб-сервера. Вернуться
+// отсюда в setup() — значит попросить полную загрузку: пора сбросить пачку,
+// появился USB, батарея на исходе или датчик не ответил.
+EarlyInit sensorOnlyWake() {
+    unsigned long t0 = micros();
+    DutyCycle::wake();
+    Serial.begin(SERIAL_BAUD);
+
+    batteryManager.begin();
+    if (batteryManager.isUsbConnected()) {
+        DutyCycle::setActive(false);   // На USB — снова всегда на связи
+        return EarlyInit::BATTERY;
+    }
+    // Сон с удвоением — обычным путём
+    if (batteryManager.isCriticalBattery()) return EarlyInit::BATTERY;
+
+    Wire.begin(I2C_SDA, I2C_SCL);
+    Wire.setClock(I2C_FREQ);
+    if (!sensorManager.begin()) return EarlyInit::BUS;   // Ошибку покажет полная загрузка
+    float t, h;
+    bool fresh = sensorManager.measure(t, h);
+    if (fresh) DutyCycle::append(t, h);
+    if (DutyCycle::flushDue()) return fresh ? EarlyInit::SENSOR : EarlyInit::BUS;
+
+    // Сон — до следующего срока на сетке SENSOR_INTERVAL
+    uint32_t awakeUs = micros() - t0;
+    DutyCycle::noteAwake(awakeUs);
+    uint64_t cycleUs = SENSOR_INTERVAL * 1000ULL;
+    Serial.printf("Duty cycle: %u samples buffered, awake %lu us\n",
+                  (unsigned)DutyCycle::count(), (unsigned long)awakeUs);
+    Serial.flush();
+    esp_sleep_enable_timer_wakeup(awakeUs < cycleUs ? cycleUs - awakeUs : cycleUs);
+    esp_deep_sleep_start();
+}
+
+// Конец окна сброса: клиенты успели забрать пачку — дальше только датчик.
+// Это штатный сон, не аварийный: без прокачки WS, сообщения на экране и
+// пауз enterDeepSleep() — гасим OLED и радио и сразу засыпаем
+void dutyCycleTask() {
+    if (batteryManager.isUsbConnected()) return;   // USB появился — остаёмся
+    DutyCycle::enter();
+    LOG_I("duty", "Sensor-only wakes every %lus until the next flush",
+          (unsigned long)(SENSOR_INTERVAL / 1000));
+    Serial.flush();
+
+    displayManager.powerOff();
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+    esp_sleep_enable_timer_wakeup(SENSOR_INTERVAL * 1000ULL);
+    esp_deep_sleep_start();
+}
+
 // ============================================
 // Functions
 // ============================================
@@ -145,7 +213,7 @@ void checkBatteryAndSleep() {
 void printSystemInfo() {
     Serial.println();
     Serial.println("╔══════════════════════════════════════════╗");
-    Serial.println("║   ESP32-C3 Weather Station v3.1          ║");
+    Serial.printf("║   ESP32-C3 Weather Station %-14s║\n", FIRMWARE_VERSION);
     Serial.println("║   AHT10 + Battery Management             ║");
     Serial.println("╚══════════════════════════════════════════╝");
     Serial.println();
@@ -167,27 +235,21 @@ void printSystemInfo() {
     Serial.println();
 }
 
+// Раз в STATS_UPDATE_INTERVAL (задача планировщика)
 void updateCPUUsage() {
-    unsigned long currentMillis = millis();
-    if (currentMillis - lastCpuCheck >= STATS_UPDATE_INTERVAL) {
-        unsigned long totalTime = busyTime + idleTime;
-        if (totalTime > 0) {
-            g_cpuUsage = (float)busyTime / totalTime * 100.0;
-            if (g_cpuUsage > 100.0) g_cpuUsage = 100.0;
-            if (g_cpuUsage < 0.0)   g_cpuUsage = 0.0;
-        }
-        busyTime = 0;
-        idleTime = 0;
-        lastCpuCheck = currentMillis;
+    unsigned long totalTime = busyTime + idleTime;
+    if (totalTime > 0) {
+        g_cpuUsage = (float)busyTime / totalTime * 100.0;
+        if (g_cpuUsage > 100.0) g_cpuUsage = 100.0;
+        if (g_cpuUsage < 0.0)   g_cpuUsage = 0.0;
     }
+    busyTime = 0;
+    idleTime = 0;
+    CpuFreq::tick();
 }
 
+// Раз в STATUS_LOG_INTERVAL (задача планировщика)
 void printStatus() {
-    static unsigned long lastPrint = 0;
-    unsigned long currentMillis = millis();
-    if (currentMillis - lastPrint < 30000) return;
-    lastPrint = currentMillis;
-
     #ifdef SOC_TEMP_SENSOR_SUPPORTED
     float chipTemp = temperatureRead();
     #else
@@ -199,51 +261,274 @@ void printStatus() {
     float    heapUsage   = (float)(totalHeap - freeHeap) / totalHeap * 100.0;
     uint32_t minFreeHeap = ESP.getMinFreeHeap();
 
-    Serial.println();
-    Serial.println("=== System Status ===");
-    Serial.printf("Uptime:       %lu sec\n", millis() / 1000);
-    Serial.printf("WiFi:         %s (%d dBm)\n",
-                  wifiManager.isConnected() ? "Connected" : "Disconnected",
-                  wifiManager.getRSSI());
-    Serial.printf("Temperature:  %.1f C\n", sensorManager.getTemperature());
-    Serial.printf("Humidity:     %.1f%%\n",  sensorManager.getHumidity());
-    Serial.printf("Battery:      %s\n", batteryManager.getSummaryString().c_str());
-    Serial.printf("CPU:          %.1f%%\n",  g_cpuUsage);
-    Serial.printf("Free Heap:    %u KB\n",   freeHeap / 1024);
-    Serial.printf("Requests:     %lu\n",     webServer.getRequestCount());
+    // Один блок и для Serial, и для WS-консоли — раньше их было два,
+    // и WS-вариант склеивал ~30 временных String за раз
+    char battery[64];
+    batteryManager.formatSummary(battery, sizeof(battery));
+
+    LOG_I("status", "=== Status Update ===");
+    LOG_I("status", "T=%.1fC  H=%.1f%%",
+          sensorManager.getTemperature(), sensorManager.getHumidity());
+    LOG_I("status", "Battery: %s", battery);
+    #ifdef SOC_TEMP_SENSOR_SUPPORTED
+    if (chipTemp > 0) LOG_I("status", "Chip: %.1fC", chipTemp);
+    #endif
+    LOG_I("status", "CPU: %.1f%%  @%lu MHz", g_cpuUsage, (unsigned long)ESP.getCpuFreqMHz());
+    LOG_I("status", "RAM: %lu KB free / %lu KB (%.1f%% used)",
+          (unsigned long)(freeHeap / 1024), (unsigned long)(totalHeap / 1024), heapUsage);
+    LOG_I("status", "Min Free: %lu KB", (unsigned long)(minFreeHeap / 1024));
+    if (wifiManager.isConnected())
+        LOG_I("status", "WiFi: %s (Ch%d  %d dBm)",
+              wifiManager.getSSIDName(), wifiManager.getChannel(), wifiManager.getRSSI());
+    else
+        LOG_W("status", "WiFi: disconnected");
+    LOG_I("status", "Requests: %lu  Errors: %d",
+          webServer.getRequestCount(), sensorManager.getReadErrorCount());
+
+    unsigned long up = millis() / 1000;
+    unsigned long d = up / 86400, h = (up % 86400) / 3600, m = (up % 3600) / 60;
+    if (d > 0) LOG_I("status", "Uptime: %lud %luh %lum", d, h, m);
+    else       LOG_I("status", "Uptime: %luh %lum", h, m);
+    LOG_I("status", "-------------------------");
+}
+
+// ============================================
+// Tasks
+// ============================================
+
+// Button: короткое нажатие — следующий экран, долгое — вкл/выкл дисплея.
+// Антидребезгу нужен частый опрос — BUTTON_POLL_INTERVAL(_BATTERY).
+void buttonTask() {
+    switch (button.poll()) {
+        case ButtonEvent::SHORT_PRESS:
+            // Если экран погашен автогашением, первое нажатие только будит его,
+            // не пролистывая — иначе непонятно, какой экран ты включил
+            if (displayManager.isOn()) {
+                displayManager.nextScreen();
+            }
+            displayManager.wake();
+            scheduler.now(displayTaskId);
+            break;
+
+        case ButtonEvent::LONG_PRESS:
+            displayManager.togglePower();
+            scheduler.now(displayTaskId);
+            LOG_I("display", "%s", displayManager.isOn() ? "Display ON (button)"
+                                                         : "Display OFF (button)");
+            break;
+
+        case ButtonEvent::NONE:
+        default:
+            break;
+    }
+}
+
+// Опрос веба и кнопки чаще на USB (задержка ответа), реже на батарее
+// (меньше пробуждений)
+void applyPollIntervals() {
+    bool usb = batteryManager.isUsbConnected();
+    scheduler.setPeriod(webTaskId, usb ? WEB_POLL_INTERVAL : WEB_POLL_INTERVAL_BATTERY);
+    scheduler.setPeriod(buttonTaskId, usb ? BUTTON_POLL_INTERVAL : BUTTON_POLL_INTERVAL_BATTERY);
+}
+
+void batteryTask() {
+    PowerSource prevSource = batteryManager.getPowerSource();
+    batteryManager.update();
+
+    if (batteryManager.getPowerSource() != prevSource) {
+        applyPollIntervals();
+
+        // Автопереключение энергосбережения WiFi по источнику питания:
+        // батарея → modem sleep включён, USB → выключен (минимальная задержка)
+        if (WIFI_POWER_SAVE_ON_BATTERY) {
+            bool onBattery = !batteryManager.isUsbConnected();
+            wifiManager.setPowerSave(onBattery);
+            LOG_I("power", "%s", onBattery ? "🔋 On battery — WiFi power save ON"
+                                           : "🔌 On USB — WiFi power save OFF");
+        }
+
+        // Ушли на батарею — через окно DUTY_CYCLE_AWAKE_MS в duty cycle
+        if (DUTY_CYCLE_ON_BATTERY) {
+            bool onBattery = !batteryManager.isUsbConnected();
+            if (onBattery) scheduler.after(dutyTaskId, DUTY_CYCLE_AWAKE_MS);
+            else           DutyCycle::setActive(false);
+        }
+
+        // Там же — частота CPU: на батарее простой на пониженной
+        if (CPU_FREQ_SCALING_ON_BATTERY) {
+            bool onBattery = !batteryManager.isUsbConnected();
+            CpuFreq::setScaling(onBattery);
+            LOG_I("power", "CPU idle clock: %lu MHz",
+                  (unsigned long)(onBattery ? CPU_FREQ_IDLE_MHZ : CPU_FREQ_MAX_MHZ));
+        }
+    }
+
+    // Check if we need to enter deep sleep
+    checkBatteryAndSleep();
+
+    // Log battery status if low — не чаще LOW_BATTERY_LOG_INTERVAL,
+    // иначе спамим каждые 10 секунд
+    if (batteryManager.isLowBattery() && !batteryManager.isUsbConnected()) {
+        static unsigned long lastLowLog = 0;
+        unsigned long now = millis();
+        if (lastLowLog == 0 || now - lastLowLog >= LOW_BATTERY_LOG_INTERVAL) {
+            lastLowLog = now;
+            LOG_W("battery", "⚠️ Low battery: %.2fV (%d%%)",
+                  batteryManager.getVoltage(), batteryManager.getPercent());
+        }
+    }
+}
+
+// Баннер загрузки. Раньше печатался в конце setup() после delay(2000) —
+// "чтобы клиенты успели подключиться", хотя до IP их быть не могло.
+// Теперь — в момент, когда WiFi поднят и веб-сервер слушает: кто
+// подключится позже, получит его из WS-кольца повтором.
+void printBanner() {
+    BootTimeline::mark(BootMark::BANNER);
+    Serial.printf("Web: http://%s/\n", wifiManager.getIP().c_str());
     Serial.println();
 
-    if (wifiManager.isConnected()) {
-        webServer.broadcastLog("=== Status Update ===");
-        webServer.broadcastLog("T=" + String(sensorManager.getTemperature(), 1) +
-                               "C  H=" + String(sensorManager.getHumidity(), 1) + "%");
-        webServer.broadcastLog("Battery: " + batteryManager.getSummaryString());
-        #ifdef SOC_TEMP_SENSOR_SUPPORTED
-        if (chipTemp > 0)
-            webServer.broadcastLog("Chip: " + String(chipTemp, 1) + "C");
-        #endif
-        webServer.broadcastLog("CPU: " + String(g_cpuUsage, 1) +
-                               "%  @" + String(ESP.getCpuFreqMHz()) + " MHz");
-        webServer.broadcastLog("RAM: " + String(freeHeap / 1024) + " KB free / " +
-                               String(totalHeap / 1024) + " KB (" +
-                               String(heapUsage, 1) + "% used)");
-        webServer.broadcastLog("Min Free: " + String(minFreeHeap / 1024) + " KB");
-        webServer.broadcastLog("WiFi: " + wifiManager.getSSID() +
-                               " (Ch" + String(wifiManager.getChannel()) +
-                               "  " + String(wifiManager.getRSSI()) + " dBm)");
-        webServer.broadcastLog("Requests: " + String(webServer.getRequestCount()) +
-                               "  Errors: " + String(sensorManager.getReadErrorCount()));
-
-        unsigned long up = millis() / 1000;
-        int d = up / 86400, h = (up % 86400) / 3600, m = (up % 3600) / 60;
-        String uStr = "Uptime: ";
-        if (d > 0) uStr += String(d) + "d ";
-        uStr += String(h) + "h " + String(m) + "m";
-        webServer.broadcastLog(uStr);
-        webServer.broadcastLog("-------------------------");
+    char ip[32];
+    wifiManager.formatIP(ip, sizeof(ip));
+    LOG_I("boot", "╔══════════════════════════════════════════╗");
+    LOG_I("boot", "║     ESP32 Weather Station Started!       ║");
+    LOG_I("boot", "╚══════════════════════════════════════════╝");
+    LOG_I("boot", "AHT10 sensor: Ready");
+    char battery[64];
+    batteryManager.formatSummary(battery, sizeof(battery));
+    LOG_I("boot", "Battery: %s", battery);
+    LOG_I("boot", "WiFi: %s", wifiManager.getSSIDName());
+    LOG_I("boot", "IP: %s", ip);
+    LOG_I("boot", "Signal: %d dBm (Ch%d)", wifiManager.getRSSI(), wifiManager.getChannel());
+    LOG_I("boot", "Hardware:");
+    LOG_I("boot", "  Chip:  %s rev%d", ESP.getChipModel(), (int)ESP.getChipRevision());
+    LOG_I("boot", "  CPU:   %lu MHz", (unsigned long)ESP.getCpuFreqMHz());
+    LOG_I("boot", "  Flash: %lu MB", (unsigned long)(ESP.getFlashChipSize() / (1024 * 1024)));
+    LOG_I("boot", "  RAM:   %lu KB", (unsigned long)(ESP.getHeapSize() / 1024));
+    LOG_I("boot", "  Free:  %lu KB", (unsigned long)(ESP.getFreeHeap() / 1024));
+    #ifdef SOC_TEMP_SENSOR_SUPPORTED
+    float ct = temperatureRead();
+    if (ct > 0) LOG_I("boot", "  Chip Temp: %.1fC", ct);
+    #endif
+    LOG_I("boot", "Initial reading:");
+    LOG_I("boot", "  Temperature: %.1fC", sensorManager.getTemperature());
+    LOG_I("boot", "  Humidity:    %.1f%%", sensorManager.getHumidity());
+    LOG_I("boot", "Monitoring interval: %lus", (unsigned long)(SENSOR_INTERVAL / 1000));
+    LOG_I("boot", "Deep Sleep: %s", DEEP_SLEEP_ENABLED ? "Enabled" : "Disabled");
+    LOG_I("boot", "Boot: first sample %lu ms, WiFi %lu ms, setup() %lu ms",
+          (unsigned long)BootTimeline::at(BootMark::FIRST_SAMPLE),
+          (unsigned long)BootTimeline::at(BootMark::WIFI_CONNECTED),
+          (unsigned long)BootTimeline::at(BootMark::SETUP_DONE));
+    LOG_I("boot", "-------------------------");
+}
+
+// Первое подключение завершилось: путь и его цена — в лог (и в историю WS),
+// по RTC-кэшу после сна должно быть в разы быстрее, чем со сканом
+void onFirstConnect() {
+    BootTimeline::mark(BootMark::WIFI_CONNECTED);
+    BootTimeline::end(BootStage::WIFI);
+    DutyCycle::delivered();   // Пачка в /history, и до неё уже можно достучаться
+    LOG_I("wifi", "Connected via %s in %lu ms, %lu ms after boot",
+          wifiManager.getConnectPath(), wifiManager.getConnectMs(),
+          wifiManager.getConnectedAtMs());
+    printBanner();
+}
+
+// checkConnection() не блокирует и сама ограничивает частоту попыток
+// реконнекта. До первого подключения задача крутится чаще
+// (WIFI_CONNECT_POLL_INTERVAL) — IP замечаем сразу, а не через полсекунды.
+void wifiTask() {
+    static bool firstConnectDone = false;
+    bool wasConnected = wifiManager.isConnected();
+    wifiManager.checkConnection();
+    bool isNowConnected = wifiManager.isConnected();
+
+    if (!firstConnectDone) {
+        static bool offlineLogged = false;
+        if (isNowConnected) {
+            firstConnectDone = true;
+            scheduler.setPeriod(wifiTaskId, WIFI_POLL_INTERVAL);
+            onFirstConnect();
+        } else if (!offlineLogged && millis() - systemStartTime > WIFI_TIMEOUT) {
+            offlineLogged = true;
+            LOG_W("wifi", "No WiFi after %lus — working offline, still trying",
+                  (unsigned long)(WIFI_TIMEOUT / 1000));
+        }
+        return;
+    }
+
+    if (!wasConnected && isNowConnected) {
+        char ip[32];
+        wifiManager.formatIP(ip, sizeof(ip));
+        LOG_I("wifi", "WiFi reconnected: %s (%s  %d dBm)",
+              wifiManager.getSSIDName(), ip, wifiManager.getRSSI());
+    } else if (wasConnected && !isNowConnected) {
+        LOG_W("wifi", "WiFi connection lost — reconnecting...");
+    }
+}
+
+// Триггер AHT10. Раньше здесь был getEvent(), который ~80 мс крутил delay()
+// внутри драйвера; теперь результат заберёт sensorPollTask(), взведённый ровно
+// на время преобразования.
+void sensorTask() {
+    if (sensorManager.startMeasurement())
+        scheduler.after(sensorPollTaskId, AHT10_CONVERSION_MS);
+    else
+        LOG_E("sensor", "Sensor error (count: %d)", sensorManager.getReadErrorCount());
+}
+
+void sensorPollTask() {
+    SensorPoll sensorState = sensorManager.poll();
+    if (sensorState == SensorPoll::BUSY) {
+        // AHT10 ещё держит BUSY — заглянем чуть позже
+        scheduler.after(sensorPollTaskId, AHT10_POLL_RETRY_MS);
+    } else if (sensorState == SensorPoll::READY) {
+        BootTimeline::mark(BootMark::FIRST_SAMPLE);   // Если в setup() не вышло
+        LOG_I("sensor", "T: %.1fC | H: %.1f%%",
+              sensorManager.getTemperature(), sensorManager.getHumidity());
+        if (wifiManager.isConnected())
+            webServer.pushSample();
+
+        static int readCount = 0;
+        if (++readCount % 3 == 0) {
+            LOG_I("sensor", "Min: T=%.1fC  H=%.1f%%",
+                  sensorManager.getMinTemp(), sensorManager.getMinHumid());
+            LOG_I("sensor", "Max: T=%.1fC  H=%.1f%%",
+                  sensorManager.getMaxTemp(), sensorManager.getMaxHumid());
+            LOG_I("sensor", "Avg: T=%.1fC  H=%.1f%%",
+                  sensorManager.getAvgTemp(), sensorManager.getAvgHumid());
+            LOG_I("sensor", "Dew Point:  %.1fC", sensorManager.getDewPoint());
+            LOG_I("sensor", "Heat Index: %.1fC", sensorManager.getHeatIndex());
+        }
+    } else if (sensorState == SensorPoll::FAILED) {
+        LOG_E("sensor", "Sensor error (count: %d)", sensorManager.getReadErrorCount());
     }
 }
 
+void registerTasks() {
+    buttonTaskId = scheduler.every(LoopPhase::BUTTON, BUTTON_POLL_INTERVAL, buttonTask);
+    // Веб-сервер зовём ВСЕГДА — он должен отвечать даже во время реконнекта WiFi.
+    // Частоту поднимают сами обработчики, когда есть что отправить (cpu_freq.h)
+    webTaskId = scheduler.every(LoopPhase::WEB, WEB_POLL_INTERVAL, 0, [] {
+        webServer.handleClient();
+    });
+    applyPollIntervals();
+    wifiTaskId = scheduler.every(LoopPhase::WIFI, WIFI_CONNECT_POLL_INTERVAL, wifiTask);
+    // Внутри update() свои интервалы (перерисовка, автосмена экрана,
+    // автогашение) — достаточно звать с шагом перерисовки
+    displayTaskId = scheduler.every(LoopPhase::DISPLAY, DISPLAY_UPDATE_INTERVAL, 0, [] {
+        displayManager.update();
+    });
+    scheduler.every(LoopPhase::BATTERY, BATTERY_CHECK_INTERVAL, batteryTask);
+    scheduler.every(LoopPhase::SENSOR, SENSOR_INTERVAL, sensorTask);
+    sensorPollTaskId = scheduler.once(LoopPhase::SENSOR, sensorPollTask);
+    dutyTaskId = scheduler.once(LoopPhase::BATTERY, dutyCycleTask);
+    if (DUTY_CYCLE_ON_BATTERY && !batteryManager.isUsbConnected())
+        scheduler.after(dutyTaskId, DUTY_CYCLE_AWAKE_MS);
+    scheduler.every(LoopPhase::STATUS, STATS_UPDATE_INTERVAL, updateCPUUsage);
+    scheduler.every(LoopPhase::STATUS, STATUS_LOG_INTERVAL, printStatus);
+}
+
 // ============================================
 // Setup
 // ============================================
@@ -254,8 +539,21 @@ void setup() {
     bool wokeFromSleep =
         (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER);
 
+    // Duty cycle: обычно отсюда сразу обратно в сон; дальше — только
+    // если нужна полная загрузка
+    DutyCycle::begin(&g_dutyCycle);
+    EarlyInit early = EarlyInit::NONE;
+    if (DUTY_CYCLE_ON_BATTERY && wokeFromSleep && DutyCycle::active())
+        early = sensorOnlyWake();
+
+    // В историю загрузок — только полные: пробуждения ради датчика
+    // вытеснили бы её за пару минут (их цена — в DutyCycle::lastAwakeUs())
+    BootTimeline::begin(&g_bootHistory, g_bootCount, (uint8_t)esp_reset_reason());
+    BootTimeline::start(BootStage::SETUP);
+
     // USB CDC Serial init (ESP32-C3 specific)
-    Serial.begin(SERIAL_BAUD);
+    BootTimeline::start(BootStage::SERIAL);
+    if (early == EarlyInit::NONE) Serial.begin(SERIAL_BAUD);
     if (!wokeFromSleep) {
         // Ждём хост только при обычном старте. При пробуждении из deep sleep
         // на батарее USB-хоста нет — ждать 5 секунд значит впустую жечь заряд
@@ -266,6 +564,13 @@ void setup() {
         }
         delay(300);
     }
+    BootTimeline::end(BootStage::SERIAL);
+    BootTimeline::mark(BootMark::SERIAL_READY);
+
+    // Строки логгера — ещё и в WS-кольцо: новые клиенты получат их повтором
+    Logger::setSink([](void*, const char* line, size_t len) {
+        webServer.broadcastLog(line, len);
+    }, nullptr);
 
     printSystemInfo();
     Serial.printf("Boot #%lu | Sleep cycles: %lu\n\n",
@@ -273,7 +578,9 @@ void setup() {
 
     // Initialize Battery Manager
     Serial.println("=== Initializing Battery Manager ===");
-    batteryManager.begin();
+    BootTimeline::start(BootStage::BATTERY);
+    if (early < EarlyInit::BATTERY) batteryManager.begin();
+    BootTimeline::end(BootStage::BATTERY);
     Serial.println();
 
     // Check battery before starting everything else.
@@ -293,13 +600,34 @@ void setup() {
         g_sleepCycles = 0;
     }
 
+    // Start WiFi.
+    // Только запуск: ассоциация (скан или по RTC-кэшу), рукопожатие и DHCP
+    // идут в фоне, пока ниже поднимаются шина, дисплей и датчик — это
+    // ~0.5 с, которые раньше стояли в очереди за подключением. Доводит
+    // подключение wifiTask(), он же печатает баннер. Батарея проверена
+    // раньше: при критическом заряде радио так и не включается.
+    Serial.println("=== Connecting to WiFi ===");
+    BootTimeline::start(BootStage::WIFI);   // Закончится в onFirstConnect()
+    wifiManager.begin();
+    BootTimeline::mark(BootMark::WIFI_START);
+    if (WIFI_POWER_SAVE_ON_BATTERY && !batteryManager.isUsbConnected()) {
+        // Стартуем на батарее — сразу включаем modem sleep
+        wifiManager.setPowerSave(true);
+        Serial.println("🔋 Battery power detected — WiFi power save ON");
+    }
+    Serial.println();
+
     // Initialize I2C bus (shared by AHT10 and SSD1306).
     // Инициализируем здесь, ДО обоих устройств: раньше это делал
     // sensorManager.begin(), но теперь шина общая и хозяин у неё один.
     Serial.println("=== Initializing I2C ===");
-    Wire.begin(I2C_SDA, I2C_SCL);
-    Wire.setClock(I2C_FREQ);
-    delay(100);
+    BootTimeline::start(BootStage::I2C);
+    if (early < EarlyInit::BUS) {
+        Wire.begin(I2C_SDA, I2C_SCL);
+        Wire.setClock(I2C_FREQ);
+        delay(100);
+    }
+    BootTimeline::end(BootStage::I2C);
     Serial.printf("SDA=GPIO%d  SCL=GPIO%d  %lu kHz\n\n",
                   I2C_SDA, I2C_SCL, (unsigned long)(I2C_FREQ / 1000));
 
@@ -307,14 +635,35 @@ void setup() {
     // Дисплей поднимаем ДО датчика — тогда фатальную ошибку AHT10
     // можно показать на экране, а не только в Serial.
     Serial.println("=== Initializing Display ===");
+    BootTimeline::start(BootStage::DISPLAY);
     displayManager.begin();
-    displayManager.showSplash("v3.1");
+    displayManager.showSplash(FIRMWARE_VERSION);
+    BootTimeline::end(BootStage::DISPLAY);
     button.begin();
     Serial.println();
 
     // Initialize sensor
     Serial.println("=== Initializing Sensor ===");
-    if (!sensorManager.begin()) {
+    BootTimeline::start(BootStage::SENSOR);
+    bool sensorFound = early == EarlyInit::SENSOR || sensorManager.begin();
+    if (sensorFound) {
+        // Пачка duty cycle — в историю тем же путём, что живые чтения, и до
+        // первого живого: старые сэмплы не встанут после нового, а текущее
+        // значение — самое свежее. Из RTC-кольца пачку уберёт подключение
+        // WiFi (onFirstConnect)
+        for (size_t i = 0; i < DutyCycle::count(); i++) {
+            float t, h;
+            DutyCycle::sample(i, t, h);
+            sensorManager.importReading(t, h);
+        }
+        if (DutyCycle::count())
+            LOG_I("duty", "Flushed %u samples to history (%lu sensor-only wakes so far)",
+                  (unsigned)DutyCycle::count(), (unsigned long)DutyCycle::wakes());
+        // При сбросе из пробуждения duty cycle свежий замер — уже последний в пачке
+        if (early != EarlyInit::SENSOR) sensorManager.readNow();
+    }
+    BootTimeline::end(BootStage::SENSOR);
+    if (!sensorFound) {
         Serial.println();
         Serial.println("╔══════════════════════════════════════════╗");
         Serial.println("║           CRITICAL ERROR!                ║");
@@ -329,21 +678,14 @@ void setup() {
                                    "check I2C wiring");
         while (1) { delay(250); }
     }
-
-    // Connect to WiFi
-    Serial.println("=== Connecting to WiFi ===");
-    if (!wifiManager.begin()) {
-        Serial.println("Cannot connect to WiFi");
-        Serial.println("  Working offline — web interface unavailable");
-    } else if (WIFI_POWER_SAVE_ON_BATTERY && !batteryManager.isUsbConnected()) {
-        // Стартуем на батарее — сразу включаем modem sleep
-        wifiManager.setPowerSave(true);
-        Serial.println("🔋 Battery power detected — WiFi power save ON");
-    }
+    if (sensorManager.getLastReadTime())
+        BootTimeline::mark(BootMark::FIRST_SAMPLE);
 
     // Launch web-server
     Serial.println("=== Launching Web Server ===");
+    BootTimeline::start(BootStage::WEB);
     webServer.begin();
+    BootTimeline::end(BootStage::WEB);
 
     Serial.println();
     Serial.println("╔══════════════════════════════════════════╗");
@@ -351,175 +693,45 @@ void setup() {
     Serial.println("╚══════════════════════════════════════════╝");
     Serial.println();
 
-    if (wifiManager.isConnected()) {
-        Serial.println("Web: http://" + wifiManager.getIP() + "/");
-        Serial.println();
-
-        delay(2000);
-        webServer.broadcastLog("╔══════════════════════════════════════════╗");
-        webServer.broadcastLog("║     ESP32 Weather Station Started!       ║");
-        webServer.broadcastLog("╚══════════════════════════════════════════╝");
-        webServer.broadcastLog("");
-        webServer.broadcastLog("AHT10 sensor: Ready");
-        webServer.broadcastLog("Battery: " + batteryManager.getSummaryString());
-        webServer.broadcastLog("WiFi: " + wifiManager.getSSID());
-        webServer.broadcastLog("IP: "   + wifiManager.getIP());
-        webServer.broadcastLog("Signal: " + String(wifiManager.getRSSI()) +
-                               " dBm (Ch" + String(wifiManager.getChannel()) + ")");
-        webServer.broadcastLog("");
-        webServer.broadcastLog("Hardware:");
-        webServer.broadcastLog("  Chip:  " + String(ESP.getChipModel()) +
-                               " rev" + String(ESP.getChipRevision()));
-        webServer.broadcastLog("  CPU:   " + String(ESP.getCpuFreqMHz()) + " MHz");
-        webServer.broadcastLog("  Flash: " + String(ESP.getFlashChipSize() / (1024*1024)) + " MB");
-        webServer.broadcastLog("  RAM:   " + String(ESP.getHeapSize() / 1024) + " KB");
-        webServer.broadcastLog("  Free:  " + String(ESP.getFreeHeap() / 1024) + " KB");
-        #ifdef SOC_TEMP_SENSOR_SUPPORTED
-        float ct = temperatureRead();
-        if (ct > 0) webServer.broadcastLog("  Chip Temp: " + String(ct, 1) + "C");
-        #endif
-        webServer.broadcastLog("");
-        webServer.broadcastLog("Initial reading:");
-        webServer.broadcastLog("  Temperature: " +
-                               String(sensorManager.getTemperature(), 1) + "C");
-        webServer.broadcastLog("  Humidity:    " +
-                               String(sensorManager.getHumidity(), 1) + "%");
-        webServer.broadcastLog("");
-        webServer.broadcastLog("Monitoring interval: " +
-                               String(SENSOR_INTERVAL / 1000) + "s");
-        webServer.broadcastLog("Deep Sleep: " + String(DEEP_SLEEP_ENABLED ? "Enabled" : "Disabled"));
-        webServer.broadcastLog("-------------------------");
-    }
+    registerTasks();
+    // Загрузка шла на полной частоте; дальше — по нагрузке
+    CpuFreq::begin(CPU_FREQ_SCALING_ON_BATTERY && !batteryManager.isUsbConnected());
+    BootTimeline::end(BootStage::SETUP);
+    BootTimeline::mark(BootMark::SETUP_DONE);
 }
 
 // ============================================
 // Main Loop
 // ============================================
 void loop() {
-    unsigned long loopStart    = micros();
-    unsigned long currentMillis = millis();
-
-    // Button: короткое нажатие — следующий экран, долгое — вкл/выкл дисплея.
-    // Опрашиваем каждую итерацию, иначе нажатия будут теряться.
-    switch (button.poll()) {
-        case ButtonEvent::SHORT_PRESS:
-            // Если экран погашен автогашением, первое нажатие только будит его,
-            // не пролистывая — иначе непонятно, какой экран ты включил
-            if (displayManager.isOn()) {
-                displayManager.nextScreen();
-            }
-            displayManager.wake();
-            break;
-
-        case ButtonEvent::LONG_PRESS:
-            displayManager.togglePower();
-            logBoth(displayManager.isOn() ? "Display ON (button)"
-                                          : "Display OFF (button)");
-            break;
-
-        case ButtonEvent::NONE:
-        default:
-            break;
-    }
-
-    // Check battery status
-    if (currentMillis - lastBatteryCheck >= BATTERY_CHECK_INTERVAL) {
-        lastBatteryCheck = currentMillis;
-        PowerSource prevSource = batteryManager.getPowerSource();
-        batteryManager.update();
-
-        // Автопереключение энергосбережения WiFi по источнику питания:
-        // батарея → modem sleep включён, USB → выключен (минимальная задержка)
-        if (WIFI_POWER_SAVE_ON_BATTERY &&
-            batteryManager.getPowerSource() != prevSource) {
-            bool onBattery = !batteryManager.isUsbConnected();
-            wifiManager.setPowerSave(onBattery);
-            logBoth(onBattery ? "🔋 On battery — WiFi power save ON"
-                              : "🔌 On USB — WiFi power save OFF");
+    unsigned long loopStart = micros();
+    LoopProfiler::beginLoop();
+
+    scheduler.runDue();
+
+    // Проход затянулся — запоминаем, кто виноват и что творилось вокруг
+    if (LoopProfiler::Stall* stall = LoopProfiler::endLoop()) {
+        stall->wsClients = webServer.getClientCount();
+        stall->wifi      = wifiManager.getStatusName();
+
+        static unsigned long lastStallLog = 0;
+        unsigned long now = millis();
+        if (lastStallLog == 0 || now - lastStallLog >= LOOP_STALL_LOG_INTERVAL) {
+            lastStallLog = now;
+            LOG_W("stall", "loop() took %lu ms, %s %lu ms (ws=%u, wifi=%s, #%lu)",
+                  (unsigned long)(stall->totalUs / 1000), LoopProfiler::name(stall->phase),
+                  (unsigned long)(stall->phaseUs / 1000), (unsigned)stall->wsClients,
+                  stall->wifi, (unsigned long)LoopProfiler::stallCount());
         }
-
-        // Check if we need to enter deep sleep
-        checkBatteryAndSleep();
-
-        // Log battery status if low — не чаще LOW_BATTERY_LOG_INTERVAL,
-        // иначе спамим каждые 10 секунд
-        if (batteryManager.isLowBattery() && !batteryManager.isUsbConnected()) {
-            static unsigned long lastLowLog = 0;
-            if (lastLowLog == 0 || currentMillis - lastLowLog >= LOW_BATTERY_LOG_INTERVAL) {
-                lastLowLog = currentMillis;
-                logBoth("⚠️ Low battery: " + String(batteryManager.getVoltage(), 2) + "V (" +
-                       String(batteryManager.getPercent()) + "%)");
-            }
-        }
-    }
-
-    // Check WiFi connection
-    // checkConnection() теперь НЕ блокирует — можно вызывать каждый тик.
-    // Внутри она сама ограничивает частоту попыток реконнекта.
-    {
-        bool wasConnected = wifiManager.isConnected();
-        wifiManager.checkConnection();
-        bool isNowConnected = wifiManager.isConnected();
-        if (!wasConnected && isNowConnected)
-            logBoth("WiFi reconnected: " + wifiManager.getSSID() +
-                    " (" + wifiManager.getIP() + "  " +
-                    String(wifiManager.getRSSI()) + " dBm)");
-        else if (wasConnected && !isNowConnected)
-            Serial.println("WiFi connection lost — reconnecting...");
     }
 
-    // Web request processing and WebSocket.
-    // Вызываем ВСЕГДА — веб-сервер должен отвечать даже во время реконнекта WiFi.
-    webServer.handleClient();
-
-    // Refresh OLED. Внутри стоит свой интервал (DISPLAY_UPDATE_INTERVAL)
-    // и политика автогашения на батарее — вызывать можно каждый тик.
-    displayManager.update();
-
-    // Read sensor data
-    if (currentMillis - lastSensorRead >= SENSOR_INTERVAL) {
-        lastSensorRead = currentMillis;
-
-        if (sensorManager.update()) {
-            float temp     = sensorManager.getTemperature();
-            float humid    = sensorManager.getHumidity();
-            float avgTemp  = sensorManager.getAvgTemp();
-            float avgHumid = sensorManager.getAvgHumid();
-
-            String log = "T: " + String(temp, 1) + "C | H: " + String(humid, 1) + "%";
-            Serial.println(log);
-
-            if (wifiManager.isConnected()) {
-                webServer.broadcastLog(log);
-
-                static int readCount = 0;
-                if (++readCount % 3 == 0) {
-                    webServer.broadcastLog("Min: T=" + String(sensorManager.getMinTemp(), 1) +
-                                          "C  H=" + String(sensorManager.getMinHumid(), 1) + "%");
-                    webServer.broadcastLog("Max: T=" + String(sensorManager.getMaxTemp(), 1) +
-                                          "C  H=" + String(sensorManager.getMaxHumid(), 1) + "%");
-                    webServer.broadcastLog("Avg: T=" + String(avgTemp, 1) +
-                                          "C  H=" + String(avgHumid, 1) + "%");
-                    float dp = WeatherCalculations::calculateDewPoint(temp, humid);
-                    float hi = WeatherCalculations::calculateHeatIndex(temp, humid);
-                    webServer.broadcastLog("Dew Point:  " + String(dp, 1) + "C");
-                    webServer.broadcastLog("Heat Index: " + String(hi, 1) + "C");
-                }
-            }
-        } else {
-            logBoth("Sensor error (count: " +
-                    String(sensorManager.getReadErrorCount()) + ")");
-        }
-    }
-
-    updateCPUUsage();
-    printStatus();
-
     unsigned long loopEnd = micros();
     busyTime += (loopEnd - loopStart);
-    // idleTime фиксированно = 10мс на итерацию (время delay в конце loop).
-    // g_cpuUsage = busyTime / (busyTime + idleTime) — относительная нагрузка loop
-    // на фоне intentional delay, а не реальный % времени CPU.
-    delay(10);
-    idleTime += 10000;
+    // Спим ровно до ближайшего срока, а не фиксированные 10 мс после работы:
+    // на USB веб опрашивается точно раз в WEB_POLL_INTERVAL, на батарее
+    // пробуждений меньше. Простой меряем — delay() отдаёт процессор задачам
+    // WiFi/lwIP и вернуться может позже; g_cpuUsage = доля времени работы.
+    unsigned long wait = scheduler.msUntilNext();
+    if (wait) delay(wait);
+    idleTime += micros() - loopEnd;
 }
@@ -0,0 +1,72 @@
+#include "scheduler.h"
+#include <Arduino.h>
+#include <limits.h>
+
+// Ближайший срок после now на абсолютной сетке, кратной периоду.
+// Проспанные периоды так пропускаются целиком, а задачи с кратными
+// периодами (кнопка 20 мс и веб 10/40 мс) просыпаются вместе — даже
+// после setPeriod() при смене питания.
+static unsigned long gridAfter(unsigned long now, unsigned long periodMs) {
+    return (now / periodMs + 1) * periodMs;
+}
+
+int Scheduler::every(LoopPhase phase, unsigned long periodMs, TaskFn fn) {
+    return every(phase, periodMs, periodMs, fn);
+}
+
+int Scheduler::every(LoopPhase phase, unsigned long periodMs, unsigned long firstMs, TaskFn fn) {
+    if (_count >= MAX_TASKS) return -1;
+    _tasks[_count] = { fn, periodMs, millis() + firstMs, phase, true };
+    return _count++;
+}
+
+int Scheduler::once(LoopPhase phase, TaskFn fn) {
+    if (_count >= MAX_TASKS) return -1;
+    _tasks[_count] = { fn, 0, 0, phase, false };
+    return _count++;
+}
+
+void Scheduler::after(int task, unsigned long delayMs) {
+    if (task < 0 || task >= _count) return;
+    _tasks[task].nextMs = millis() + delayMs;
+    _tasks[task].armed  = true;
+}
+
+void Scheduler::setPeriod(int task, unsigned long periodMs) {
+    if (task < 0 || task >= _count) return;
+    Task& t = _tasks[task];
+    // Новый период действует сразу: ждать старый (вдруг 40 мс вместо 10) незачем
+    unsigned long next = gridAfter(millis(), periodMs);
+    if ((long)(next - t.nextMs) < 0) t.nextMs = next;
+    t.periodMs = periodMs;
+}
+
+void Scheduler::runDue() {
+    for (int i = 0; i < _count; i++) {
+        Task& t = _tasks[i];
+        unsigned long now = millis();
+        if (!t.armed || (long)(now - t.nextMs) < 0) continue;
+
+        // Срок сдвигаем ДО запуска: задача может перевзвести себя через after()
+        if (t.periodMs) {
+            t.nextMs = gridAfter(now, t.periodMs);
+        } else {
+            t.armed = false;
+        }
+        t.fn();
+        LoopProfiler::lap(t.phase);
+    }
+}
+
+unsigned long Scheduler::msUntilNext() const {
+    unsigned long now  = millis();
+    unsigned long wait = ULONG_MAX;
+    for (int i = 0; i < _count; i++) {
+        const Task& t = _tasks[i];
+        if (!t.armed) continue;
+        long left = (long)(t.nextMs - now);
+        if (left <= 0) return 0;
+        if ((unsigned long)left < wait) wait = (unsigned long)left;
+    }
+    return wait;
+}
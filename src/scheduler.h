@@ -0,0 +1,63 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include "loop_profiler.h"
+
+// ============================================
+// Кооперативный планировщик по дедлайнам
+// ============================================
+// Вместо "опросить всех каждый тик и уснуть на 10 мс" loop() запускает
+// только задачи, чей срок наступил, и спит ровно до ближайшего следующего:
+//
+//   int t = scheduler.every(LoopPhase::BATTERY, 10000, [] { batteryManager.update(); });
+//   ...
+//   void loop() {
+//       scheduler.runDue();
+//       delay(scheduler.msUntilNext());
+//   }
+//
+// Сроки лежат на сетке, кратной периоду, а не отсчитываются от факта
+// запуска: период не "уплывает" на длительность задачи, задачи с кратными
+// периодами просыпаются вместе; проспали несколько периодов — догоняем один раз.
+// Задача с периодом 0 разовая: её взводит after(), например опрос AHT10
+// через время преобразования после триггера.
+//
+// Задач немного (< 12), поэтому таблица фиксированная, а ближайший срок
+// ищется линейным проходом — куча или колесо таймеров здесь лишние.
+// Каждый запуск пишется в профиль loop() под фазой задачи.
+class Scheduler {
+public:
+    typedef void (*TaskFn)();
+
+    static constexpr int MAX_TASKS = 12;
+
+    // Периодическая задача; первый запуск — через periodMs (или firstMs).
+    // Возвращает номер задачи или -1, если таблица полна.
+    int every(LoopPhase phase, unsigned long periodMs, TaskFn fn);
+    int every(LoopPhase phase, unsigned long periodMs, unsigned long firstMs, TaskFn fn);
+
+    // Разовая задача: спит, пока её не взведут after()
+    int once(LoopPhase phase, TaskFn fn);
+
+    void after(int task, unsigned long delayMs);   // Следующий запуск через delayMs
+    void now(int task) { after(task, 0); }
+    void setPeriod(int task, unsigned long periodMs);
+
+    void          runDue();
+    unsigned long msUntilNext() const;   // 0 — что-то уже просрочено
+
+private:
+    struct Task {
+        TaskFn        fn;
+        unsigned long periodMs;
+        unsigned long nextMs;
+        LoopPhase     phase;
+        bool          armed;
+    };
+
+    Task _tasks[MAX_TASKS] = {};
+    int  _count = 0;
+};
+
+#endif // SCHEDULER_H
@@ -1,19 +1,29 @@
 #include "sensor_manager.h"
 #include "config.h"
+#include <Wire.h>
+
+// Команды AHT10 (те же, что шлёт Adafruit_AHTX0::getEvent())
+static constexpr uint8_t AHT10_CMD_TRIGGER[] = { 0xAC, 0x33, 0x00 };
+static constexpr uint8_t AHT10_STATUS_BUSY   = 0x80;
 
 SensorManager::SensorManager() 
-    : _temperature(0.0), _humidity(0.0),
+    : _measuring(false), _triggerTime(0),
+      _conversionMs(0), _lastBlockUs(0), _maxBlockUs(0),
+      _temperature(0.0), _humidity(0.0),
+      _dewPoint100(0), _heatIndex100(0),
       _minTemp(TEMP_INIT_MIN), _maxTemp(TEMP_INIT_MAX),
       _minHumid(HUMID_INIT_MIN), _maxHumid(HUMID_INIT_MAX),
       _historyIndex(0), _historyCount(0),
       _avgTempAccum(0.0), _avgHumidAccum(0.0), _avgCount(0),
       _hadFirstRead(false),
-      _readErrorCount(0), _lastSuccessfulRead(0) {
+      _readErrorCount(0), _lastSuccessfulRead(0),
+      _generation(0) {
     
     for(int i = 0; i < HISTORY_SIZE; i++) {
-        _tempHistory[i] = 0;
-        _humidHistory[i] = 0;
+        _history[i] = { 0, 0, 0, 0 };
     }
+    _acc5min.reset();
+    _accHourly.reset();
 }
 
 SensorManager::~SensorManager() {
@@ -33,41 +43,104 @@ bool SensorManager::begin() {
     }
     
     Serial.println("✓ AHT10 initialized successfully");
-    
-    // The first read is for initialization
-    sensors_event_t humid, temp;
-    if (_aht.getEvent(&humid, &temp)) {
-        _temperature = temp.temperature;
-        _humidity = humid.relative_humidity;
-        
-        if (validateReading(_temperature, _humidity)) {
-            _minTemp = _maxTemp = _temperature;
-            _minHumid = _maxHumid = _humidity;
-            _avgTempAccum  = _temperature;
-            _avgHumidAccum = _humidity;
-            _avgCount      = 1;
-            _hadFirstRead  = true;
-            _lastSuccessfulRead = millis();
-            Serial.printf("Initial values: T=%.1f°C, H=%.1f%%\n", 
-                         _temperature, _humidity);
-        }
+    return true;
+}
+
+bool SensorManager::measure(float& temp, float& humid) {
+    // Блокирующее чтение библиотеки (~80 мс) — только при загрузке, пока
+    // loop() ещё не крутится
+    sensors_event_t h, t;
+    if (!_aht.getEvent(&h, &t)) return false;
+    temp  = t.temperature;
+    humid = h.relative_humidity;
+    return validateReading(temp, humid);
+}
+
+bool SensorManager::readNow() {
+    float temp, humid;
+    return measure(temp, humid) && applyReading(temp, humid);
+}
+
+bool SensorManager::startMeasurement() {
+    if (_measuring) return true;   // Предыдущее ещё не забрали — не перезапускаем
+
+    unsigned long t0 = micros();
+    Wire.beginTransmission(AHT10_I2C_ADDR);
+    Wire.write(AHT10_CMD_TRIGGER, sizeof(AHT10_CMD_TRIGGER));
+    bool ok = Wire.endTransmission() == 0;
+    noteBlock(t0);
+
+    if (!ok) {
+        _readErrorCount++;
+        Serial.println("✗ Sensor reading error (trigger)");
+        return false;
     }
-    
+
+    _measuring   = true;
+    _triggerTime = millis();
     return true;
 }
 
-bool SensorManager::update() {
-    sensors_event_t humid, temp;
-    
-    if (!_aht.getEvent(&humid, &temp)) {
+SensorPoll SensorManager::poll() {
+    if (!_measuring) return SensorPoll::IDLE;
+
+    unsigned long elapsed = millis() - _triggerTime;
+    if (elapsed < AHT10_CONVERSION_MS) return SensorPoll::BUSY;
+
+    unsigned long t0 = micros();
+
+    // Статус — первый байт ответа; пока BUSY, остальные не читаем
+    uint8_t status = 0xFF;
+    if (Wire.requestFrom(AHT10_I2C_ADDR, (size_t)1) == 1) {
+        status = (uint8_t)Wire.read();
+    }
+    if (status & AHT10_STATUS_BUSY) {
+        noteBlock(t0);
+        if (elapsed < AHT10_TIMEOUT_MS) return SensorPoll::BUSY;
+        _measuring = false;
+        _readErrorCount++;
+        Serial.println("✗ Sensor reading error (timeout)");
+        return SensorPoll::FAILED;
+    }
+
+    uint8_t data[6];
+    bool ok = Wire.requestFrom(AHT10_I2C_ADDR, sizeof(data)) == sizeof(data);
+    if (ok) {
+        for (uint8_t& b : data) b = (uint8_t)Wire.read();
+    }
+    noteBlock(t0);
+
+    _measuring = false;
+    if (!ok) {
         _readErrorCount++;
         Serial.println("✗ Sensor reading error");
-        return false;
+        return SensorPoll::FAILED;
     }
-    
-    float newTemp = temp.temperature;
-    float newHumid = humid.relative_humidity;
-    
+    _conversionMs = millis() - _triggerTime;
+
+    // 20-битные сырые значения, формулы из даташита AHT10
+    uint32_t rawH = ((uint32_t)data[1] << 12) | ((uint32_t)data[2] << 4) | (data[3] >> 4);
+    uint32_t rawT = (((uint32_t)data[3] & 0x0F) << 16) | ((uint32_t)data[4] << 8) | data[5];
+    float newHumid = (float)rawH * 100.0f / 0x100000;
+    float newTemp  = (float)rawT * 200.0f / 0x100000 - 50.0f;
+
+    return applyReading(newTemp, newHumid) ? SensorPoll::READY : SensorPoll::FAILED;
+}
+
+bool SensorManager::isMeasuring() const {
+    return _measuring;
+}
+
+void SensorManager::noteBlock(unsigned long startUs) {
+    _lastBlockUs = micros() - startUs;
+    if (_lastBlockUs > _maxBlockUs) _maxBlockUs = _lastBlockUs;
+}
+
+bool SensorManager::importReading(float temp, float humid) {
+    return applyReading(temp, humid);
+}
+
+bool SensorManager::applyReading(float newTemp, float newHumid) {
     // Data validation
     if (!validateReading(newTemp, newHumid)) {
         _readErrorCount++;
@@ -79,6 +152,7 @@ bool SensorManager::update() {
     // Updating
     _temperature = newTemp;
     _humidity = newHumid;
+    updateDerived();
     _lastSuccessfulRead = millis();
     _hadFirstRead = true;
     
@@ -100,6 +174,7 @@ bool SensorManager::update() {
     }
     
     updateHistory();
+    _generation++;
     
     Serial.printf("T: %.1f°C | H: %.1f%% | Avg: T=%.1f°C H=%.1f%%\n", 
                  _temperature, _humidity, getAvgTemp(), getAvgHumid());
@@ -107,15 +182,49 @@ bool SensorManager::update() {
     return true;
 }
 
+void SensorManager::updateDerived() {
+    // Производные — один раз на чтение (O(1)), дальше их только читают:
+    // /data, /history, OLED и лог в loop()
+    int16_t  t100 = packTemp(_temperature);
+    uint16_t h100 = packHumid(_humidity);
+    _dewPoint100  = WeatherCalculations::dewPointC100(t100, h100);
+    _heatIndex100 = WeatherCalculations::heatIndexC100(t100, h100);
+}
+
 void SensorManager::updateHistory() {
-    // Circular buffer for the last HISTORY_SIZE readings (10-min window at 10s interval)
-    _tempHistory[_historyIndex] = _temperature;
-    _humidHistory[_historyIndex] = _humidity;
+    // Circular buffer for the last HISTORY_SIZE readings (1 h window at the 30 s SENSOR_INTERVAL)
+    _history[_historyIndex] = { packTemp(_temperature), packHumid(_humidity),
+                                _dewPoint100, _heatIndex100 };
     _historyIndex = (_historyIndex + 1) % HISTORY_SIZE;
     
     if (_historyCount < HISTORY_SIZE) {
         _historyCount++;
     }
+
+    updateTiers();
+}
+
+void SensorManager::updateTiers() {
+    // Каскад по счётчикам, а не по millis(): пропущенное чтение просто
+    // удлиняет корзину, но не рвёт её. Каждый шаг — O(1).
+    static constexpr int READS_PER_5MIN  = HISTORY_5MIN_STEP / SENSOR_INTERVAL;
+    static constexpr int BUCKETS_PER_HOUR = HISTORY_HOURLY_STEP / HISTORY_5MIN_STEP;
+
+    HistoryBucket sample = { _temperature, _temperature, _temperature,
+                             _humidity,    _humidity,    _humidity,
+                             getDewPoint(), getHeatIndex() };
+    _acc5min.add(sample);
+    if (_acc5min.count < READS_PER_5MIN) return;
+
+    HistoryBucket bucket5 = _acc5min.result();
+    _hist5min.push(bucket5);
+    _acc5min.reset();
+
+    _accHourly.add(bucket5);
+    if (_accHourly.count < BUCKETS_PER_HOUR) return;
+
+    _histHourly.push(_accHourly.result());
+    _accHourly.reset();
 }
 
 bool SensorManager::validateReading(float temp, float humid) {
@@ -139,6 +248,7 @@ void SensorManager::resetMinMax() {
     _maxTemp = _temperature;
     _minHumid = _humidity;
     _maxHumid = _humidity;
+    _generation++;
     Serial.println("✓ Min/Max have been reset");
 }
 
@@ -150,6 +260,14 @@ float SensorManager::getHumidity() const {
     return _humidity;
 }
 
+float SensorManager::getDewPoint() const {
+    return unpackTemp(_dewPoint100);
+}
+
+float SensorManager::getHeatIndex() const {
+    return unpackTemp(_heatIndex100);
+}
+
 float SensorManager::getMinTemp() const {
     return _minTemp;
 }
@@ -182,15 +300,15 @@ void SensorManager::getHistory(float* tempHist, float* humidHist, int size) cons
     // If the buffer is not full yet, the data simply lies from 0 to _historyCount.
     if (_historyCount < HISTORY_SIZE) {
         for (int i = 0; i < count; i++) {
-            tempHist[i]  = _tempHistory[i];
-            humidHist[i] = _humidHistory[i];
+            tempHist[i]  = unpackTemp(_history[i].temp);
+            humidHist[i] = unpackHumid(_history[i].humid);
         }
     } else {
         // The buffer is full and has already rotated — the oldest element is on _historyIndex
         for (int i = 0; i < count; i++) {
             int idx = (_historyIndex + i) % HISTORY_SIZE;
-            tempHist[i]  = _tempHistory[idx];
-            humidHist[i] = _humidHistory[idx];
+            tempHist[i]  = unpackTemp(_history[idx].temp);
+            humidHist[i] = unpackHumid(_history[idx].humid);
         }
     }
 }
@@ -203,6 +321,51 @@ int SensorManager::getHistoryCount() const {
     return _historyCount;
 }
 
+int SensorManager::getTierCount(HistoryTier tier) const {
+    switch (tier) {
+        case HistoryTier::MIN5:   return _hist5min.count;
+        case HistoryTier::HOURLY: return _histHourly.count;
+        default:                  return _historyCount;
+    }
+}
+
+bool SensorManager::getTierBucket(HistoryTier tier, int i, PackedBucket& out) const {
+    if (i < 0 || i >= getTierCount(tier)) return false;
+
+    switch (tier) {
+        case HistoryTier::MIN5:
+            out = _hist5min.at(i);
+            return true;
+        case HistoryTier::HOURLY:
+            out = _histHourly.at(i);
+            return true;
+        default: {
+            // Пока буфер не заполнен, _historyIndex == _historyCount, и формула
+            // даёт тот же порядок, что getHistory()
+            int idx = (_historyIndex - _historyCount + i + HISTORY_SIZE) % HISTORY_SIZE;
+            const PackedSample& p = _history[idx];
+            out = { p.temp, p.temp, p.temp, p.humid, p.humid, p.humid, p.dew, p.heat };
+            return true;
+        }
+    }
+}
+
+int SensorManager::getTierCapacity(HistoryTier tier) {
+    switch (tier) {
+        case HistoryTier::MIN5:   return HISTORY_5MIN_SIZE;
+        case HistoryTier::HOURLY: return HISTORY_HOURLY_SIZE;
+        default:                  return HISTORY_SIZE;
+    }
+}
+
+unsigned long SensorManager::getTierStep(HistoryTier tier) {
+    switch (tier) {
+        case HistoryTier::MIN5:   return HISTORY_5MIN_STEP;
+        case HistoryTier::HOURLY: return HISTORY_HOURLY_STEP;
+        default:                  return SENSOR_INTERVAL;
+    }
+}
+
 bool SensorManager::isValid() const {
     // Never read yet → not valid
     if (!_hadFirstRead) return false;
@@ -213,3 +376,31 @@ bool SensorManager::isValid() const {
 int SensorManager::getReadErrorCount() const {
     return _readErrorCount;
 }
+
+unsigned long SensorManager::getLastReadTime() const {
+    return _lastSuccessfulRead;
+}
+
+uint32_t SensorManager::getGeneration() const {
+    return _generation;
+}
+
+uint32_t SensorManager::getTierGeneration(HistoryTier tier) const {
+    switch (tier) {
+        case HistoryTier::MIN5:   return _hist5min.pushes;
+        case HistoryTier::HOURLY: return _histHourly.pushes;
+        default:                  return _generation;
+    }
+}
+
+unsigned long SensorManager::getConversionMs() const {
+    return _conversionMs;
+}
+
+unsigned long SensorManager::getLastBlockUs() const {
+    return _lastBlockUs;
+}
+
+unsigned long SensorManager::getMaxBlockUs() const {
+    return _maxBlockUs;
+}
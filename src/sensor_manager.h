@@ -3,6 +3,117 @@
 
 #include <Adafruit_AHTX0.h>
 #include "config.h"
+#include "calculations.h"
+
+// ============================================
+// История: сырые точки + свёртки min/max/mean
+// ============================================
+enum class HistoryTier : uint8_t {
+    RAW = 0,    // Каждое чтение (SENSOR_INTERVAL), HISTORY_SIZE точек
+    MIN5,       // Корзины по 5 минут, HISTORY_5MIN_SIZE штук
+    HOURLY      // Корзины по 1 часу,  HISTORY_HOURLY_SIZE штук
+};
+
+// Корзина на время свёртки (HistoryAccumulator), до упаковки в PackedBucket.
+// dew/heat считаются один раз при закрытии корзины (от средних),
+// обработчики их только читают.
+struct HistoryBucket {
+    float tempMin, tempMax, tempMean;
+    float humidMin, humidMax, humidMean;
+    float dew, heat;
+};
+
+// Упакованное хранение: сотые доли °C / %RH. AHT10 больше и не различает,
+// а 16 бит вместо 32 вдвое увеличивают глубину истории в той же RAM.
+// Диапазон int16 (±327 °C) с запасом покрывает TEMP_MIN_VALID..TEMP_MAX_VALID.
+inline int16_t packTemp(float t)   { return (int16_t)lroundf(t * 100.0f); }
+inline uint16_t packHumid(float h) { return (uint16_t)lroundf(h * 100.0f); }
+inline float unpackTemp(int16_t t)   { return t / 100.0f; }
+inline float unpackHumid(uint16_t h) { return h / 100.0f; }
+
+struct PackedSample {
+    int16_t  temp;    // °C × 100
+    uint16_t humid;   // %RH × 100
+    int16_t  dew;     // Точка росы, °C × 100
+    int16_t  heat;    // Heat index, °C × 100
+};
+
+struct PackedBucket {
+    int16_t  tempMin, tempMax, tempMean;
+    uint16_t humidMin, humidMax, humidMean;
+    int16_t  dew, heat;
+};
+
+static_assert(sizeof(PackedSample) == 8,  "PackedSample must stay 8 bytes");
+static_assert(sizeof(PackedBucket) == 16, "PackedBucket must stay 16 bytes");
+
+// Накопитель незакрытой корзины: O(1) на добавление, без хранения точек
+struct HistoryAccumulator {
+    HistoryBucket b;
+    double tempSum;
+    double humidSum;
+    int    count;
+
+    void reset() { count = 0; tempSum = humidSum = 0.0; }
+
+    void add(const HistoryBucket& in) {
+        if (count == 0) {
+            b = in;
+        } else {
+            if (in.tempMin  < b.tempMin)  b.tempMin  = in.tempMin;
+            if (in.tempMax  > b.tempMax)  b.tempMax  = in.tempMax;
+            if (in.humidMin < b.humidMin) b.humidMin = in.humidMin;
+            if (in.humidMax > b.humidMax) b.humidMax = in.humidMax;
+        }
+        tempSum  += in.tempMean;
+        humidSum += in.humidMean;
+        count++;
+    }
+
+    // Корзина закрывается раз в 5 минут / час — тут и считаем производные
+    HistoryBucket result() const {
+        HistoryBucket out = b;
+        out.tempMean  = (float)(tempSum  / count);
+        out.humidMean = (float)(humidSum / count);
+        int16_t  t = packTemp(out.tempMean);
+        uint16_t h = packHumid(out.humidMean);
+        out.dew  = WeatherCalculations::dewPointC100(t, h) / 100.0f;
+        out.heat = WeatherCalculations::heatIndexC100(t, h) / 100.0f;
+        return out;
+    }
+};
+
+// Кольцевой буфер корзин фиксированного размера. Хранит упакованно:
+// упаковка — на push(), читают как есть (JsonWriter::centi() без float)
+template <int N>
+struct HistoryRing {
+    PackedBucket buf[N];
+    int index = 0;
+    int count = 0;
+    uint32_t pushes = 0;   // Всего добавлено — меняется вместе с содержимым
+
+    void push(const HistoryBucket& v) {
+        buf[index] = { packTemp(v.tempMin),   packTemp(v.tempMax),   packTemp(v.tempMean),
+                       packHumid(v.humidMin), packHumid(v.humidMax), packHumid(v.humidMean),
+                       packTemp(v.dew),       packTemp(v.heat) };
+        index = (index + 1) % N;
+        if (count < N) count++;
+        pushes++;
+    }
+
+    // i = 0 — самая старая корзина
+    const PackedBucket& at(int i) const {
+        return buf[(index - count + i + N) % N];
+    }
+};
+
+// Результат SensorManager::poll()
+enum class SensorPoll : uint8_t {
+    IDLE,       // Измерение не запущено
+    BUSY,       // Преобразование ещё идёт
+    READY,      // Новое значение принято
+    FAILED      // Ошибка I2C, таймаут или невалидные данные
+};
 
 class SensorManager {
 public:
@@ -10,12 +121,39 @@ public:
     ~SensorManager();
     
     bool begin();
-    bool update();
     void resetMinMax();
+
+    // Блокирующее чтение при загрузке. measure() только возвращает значение
+    // (пробуждение duty cycle кладёт его в RTC-кольцо), readNow() ещё и
+    // принимает его как живое — после пачки из RTC, чтобы оно было новейшим
+    bool measure(float& temp, float& humid);
+    bool readNow();
+
+    // Неблокирующее чтение: startMeasurement() шлёт триггер и сразу
+    // возвращается, poll() зовётся через AHT10_CONVERSION_MS (и дальше, пока
+    // BUSY) и забирает результат, когда AHT10 снимет BUSY. Ни одного delay() внутри.
+    bool       startMeasurement();
+    SensorPoll poll();
+    bool       isMeasuring() const;
+
+    // Чтение, сделанное раньше (пачка duty cycle из RTC): тот же приём,
+    // что у живого — min/max, среднее, история и свёртки
+    bool importReading(float temp, float humid);
+
+    // Диагностика: сколько длилось преобразование и сколько loop()
+    // реально простоял в вызовах startMeasurement()/poll() (только I2C)
+    unsigned long getConversionMs() const;
+    unsigned long getLastBlockUs() const;
+    unsigned long getMaxBlockUs() const;
     
     // Getters of current values
     float getTemperature() const;
     float getHumidity() const;
+
+    // Точка росы и heat index текущего значения — считаются один раз
+    // при приёме чтения, а не в каждом обработчике
+    float getDewPoint() const;
+    float getHeatIndex() const;
     
     // Getters min/max
     float getMinTemp() const;
@@ -31,17 +169,42 @@ public:
     void getHistory(float* tempHist, float* humidHist, int size) const;
     int  getHistoryIndex() const;
     int  getHistoryCount() const;
+
+    // Многоуровневая история. Доступ поштучно (i = 0 — самая старая точка),
+    // чтобы обработчики не копировали сотни корзин на стек loop-задачи.
+    // Корзина — как хранится, в сотых: в JSON её пишет JsonWriter::centi().
+    // Для RAW min == max == mean.
+    int  getTierCount(HistoryTier tier) const;
+    bool getTierBucket(HistoryTier tier, int i, PackedBucket& out) const;
+    static int           getTierCapacity(HistoryTier tier);
+    static unsigned long getTierStep(HistoryTier tier);   // мс на точку
     
     // Sensor
     bool isValid() const;
     int getReadErrorCount() const;
+    unsigned long getLastReadTime() const;   // millis() последнего успешного чтения
+
+    // Поколение опубликованных данных: растёт при каждом принятом чтении
+    // и сбросе min/max. По нему WeatherWebServer понимает, что кэш ответа устарел.
+    uint32_t getGeneration() const;
+    // То же для отдельного ряда истории: свёртки меняются раз в 5 мин / 1 ч
+    uint32_t getTierGeneration(HistoryTier tier) const;
     
 private:
     Adafruit_AHTX0 _aht;
+
+    // Состояние неблокирующего чтения
+    bool          _measuring;
+    unsigned long _triggerTime;
+    unsigned long _conversionMs;
+    unsigned long _lastBlockUs;
+    unsigned long _maxBlockUs;
     
     // Current values
     float _temperature;
     float _humidity;
+    int16_t _dewPoint100;    // °C × 100
+    int16_t _heatIndex100;   // °C × 100
     
     // Min/Max values
     float _minTemp;
@@ -49,9 +212,8 @@ private:
     float _minHumid;
     float _maxHumid;
     
-    // History for the graph (3 minutes)
-    float _tempHistory[HISTORY_SIZE];
-    float _humidHistory[HISTORY_SIZE];
+    // History for the graph (HISTORY_SIZE raw points, packed)
+    PackedSample _history[HISTORY_SIZE];
     int _historyIndex;
     int _historyCount;
     
@@ -59,6 +221,12 @@ private:
     double _avgTempAccum;
     double _avgHumidAccum;
     int    _avgCount;
+
+    // Свёртки: 10 чтений → корзина 5 мин, 12 корзин 5 мин → корзина 1 ч
+    HistoryAccumulator _acc5min;
+    HistoryAccumulator _accHourly;
+    HistoryRing<HISTORY_5MIN_SIZE>   _hist5min;
+    HistoryRing<HISTORY_HOURLY_SIZE> _histHourly;
     
     // Internal state for isValid
     bool _hadFirstRead;
@@ -66,9 +234,15 @@ private:
     // Error statistics
     int _readErrorCount;
     unsigned long _lastSuccessfulRead;
+
+    uint32_t _generation;
     
     // Internal methods
+    bool applyReading(float newTemp, float newHumid);
+    void noteBlock(unsigned long startUs);
+    void updateDerived();
     void updateHistory();
+    void updateTiers();
     bool validateReading(float temp, float humid);
 };
 
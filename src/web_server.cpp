@@ -1,6 +1,12 @@
 #include "web_server.h"
-#include "html_pages.h"
+#include "html_page_gz.h"   // Генерируется из html_pages.h (tools/build_page.py)
 #include "config.h"
+#include "alloc_counter.h"
+#include "logger.h"
+#include "loop_profiler.h"
+#include "cpu_freq.h"
+#include "boot_timeline.h"
+#include "duty_cycle.h"
 #include <esp_system.h>
 
 // Внешняя переменная из main.cpp
@@ -13,27 +19,41 @@ WeatherWebServer::WeatherWebServer(SensorManager* sensor, WiFiManager* wifi, Bat
       _wifi(wifi),
       _battery(battery),
       _bootTime(0),
-      _requestCount(0) {
+      _requestCount(0),
+      _bodyAllocsData(0), _bodyAllocsStats(0), _bodyAllocsHistory(0), _allocsInSink(0),
+      _dataCacheLen(0), _dataCacheGen(0),
+      _historyCacheLen(0), _historyCacheGen(0),
+      _cacheHits(0), _cacheMisses(0),
+      _bootId(0), _notModifiedCount(0), _pushCount(0), _pushOverflows(0),
+      _logDropPending(), _logFrames(0), _logDropped(0) {
 }
 
 void WeatherWebServer::begin() {
     _bootTime = millis();
+    _bootId = esp_random();
     
     Serial.println("\n=== Web Server ===");
     Serial.println("Настройка маршрутов...");
     
-    // Основные маршруты
-    _server.on("/", HTTP_GET, [this]() { handleRoot(); });
-    _server.on("/data", HTTP_GET, [this]() { handleData(); });
-    _server.on("/stats", HTTP_GET, [this]() { handleStats(); });
-    _server.on("/history", HTTP_GET, [this]() { handleHistory(); });
-    _server.on("/reset", HTTP_GET, [this]() { handleReset(); });
-    _server.on("/reboot", HTTP_GET, [this]() { handleReboot(); });
-    _server.onNotFound([this]() { handleNotFound(); });
+    // Основные маршруты. Ответ собирается на полной частоте (cpu_freq.h):
+    // Boost берём в обработчике, а не вокруг опроса — пустой опрос частоту не трогает
+    _server.on("/", HTTP_GET, [this]() { CpuFreq::Boost boost; handleRoot(); });
+    _server.on("/data", HTTP_GET, [this]() { CpuFreq::Boost boost; handleData(); });
+    _server.on("/stats", HTTP_GET, [this]() { CpuFreq::Boost boost; handleStats(); });
+    _server.on("/history", HTTP_GET, [this]() { CpuFreq::Boost boost; handleHistory(); });
+    _server.on("/reset", HTTP_GET, [this]() { CpuFreq::Boost boost; handleReset(); });
+    _server.on("/reboot", HTTP_GET, [this]() { CpuFreq::Boost boost; handleReboot(); });
+    _server.onNotFound([this]() { CpuFreq::Boost boost; handleNotFound(); });
+
+    // WebServer сохраняет только перечисленные заголовки запроса
+    static const char* collected[] = { "If-None-Match" };
+    _server.collectHeaders(collected, sizeof(collected) / sizeof(collected[0]));
     
     _server.begin();
     Serial.printf("✓ HTTP сервер запущен на порту %d\n", WEB_SERVER_PORT);
-    Serial.printf("  Адрес: http://%s/\n", _wifi->getIP().c_str());
+    // При загрузке WiFi ещё подключается — адрес напечатает баннер
+    if (_wifi->isConnected())
+        Serial.printf("  Адрес: http://%s/\n", _wifi->getIP().c_str());
     
     // Запуск WebSocket сервера
     _wsServer.begin();
@@ -42,13 +62,16 @@ void WeatherWebServer::begin() {
     });
     
     Serial.printf("✓ WebSocket сервер запущен на порту 81\n");
-    Serial.printf("  ws://%s:81/\n", _wifi->getIP().c_str());
+    if (_wifi->isConnected())
+        Serial.printf("  ws://%s:81/\n", _wifi->getIP().c_str());
     Serial.println("");
 }
 
 void WeatherWebServer::handleClient() {
     _server.handleClient();
+    if (_requestCount) BootTimeline::mark(BootMark::FIRST_HTTP);
     _wsServer.loop();  // Обработка WebSocket событий
+    flushLogs();
 }
 
 void WeatherWebServer::webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
@@ -58,12 +81,22 @@ void WeatherWebServer::webSocketEvent(uint8_t num, WStype_t type, uint8_t* paylo
             break;
             
         case WStype_CONNECTED: {
+            CpuFreq::Boost boost;   // Приветствие и снимок
             IPAddress ip = _wsServer.remoteIP(num);
             Serial.printf("[WS] Client #%u connected from %s\n", num, ip.toString().c_str());
             
             // Отправляем приветственное сообщение
             String welcome = "✓ Serial Monitor connected";
             _wsServer.sendTXT(num, welcome);
+
+            // Лог — с истории: баннер загрузки и всё, что ещё помнит кольцо.
+            // Сама отправка — в flushLogs(), по кадру за проход loop()
+            _logReaders[num] = _logRing.reader(LOG_REPLAY_SIZE);
+            _logDropPending[num] = 0;
+
+            // И сразу текущий снимок — карточкам не ждать следующего чтения
+            size_t len = writeSnapshot(false);
+            if (len) _wsServer.sendTXT(num, _pushBuf, len);
             break;
         }
             
@@ -82,21 +115,158 @@ void WeatherWebServer::webSocketEvent(uint8_t num, WStype_t type, uint8_t* paylo
 }
 
 void WeatherWebServer::broadcastLog(const String& message) {
-    // Отправка логов всем подключенным WebSocket клиентам
-    // WebSockets 2.x: broadcastTXT принимает String& (не const) — копия обязательна
-    String payload = message;
-    _wsServer.broadcastTXT(payload);
+    _logRing.append(message.c_str(), message.length());
+}
+
+void WeatherWebServer::broadcastLog(const char* message) {
+    _logRing.append(message, strlen(message));
+}
+
+void WeatherWebServer::broadcastLog(const char* message, size_t len) {
+    _logRing.append(message, len);
+}
+
+void WeatherWebServer::flushLogs() {
+    if (_wsServer.connectedClients() == 0) return;
+
+    // Частоту поднимаем, только если кадр действительно уйдёт
+    bool due = false;
+    for (uint8_t num = 0; num < WEBSOCKETS_SERVER_CLIENT_MAX && !due; num++)
+        due = _wsServer.clientIsConnected(num) &&
+              (_logRing.pending(_logReaders[num]) || _logDropPending[num]);
+    if (!due) return;
+    CpuFreq::Boost boost;
+
+    // Отметка о пропуске встаёт перед строками — место под неё в начале кадра
+    static constexpr size_t MARK_SIZE = 48;
+    char frame[LOG_FRAME_SIZE];
+    char* lines = frame + MARK_SIZE;
+    const size_t cap = sizeof(frame) - MARK_SIZE - 1;   // + '\0'
+
+    for (uint8_t num = 0; num < WEBSOCKETS_SERVER_CLIENT_MAX; num++) {
+        if (!_wsServer.clientIsConnected(num)) continue;
+        LogRing<LOG_RING_SIZE>::Reader& r = _logReaders[num];
+        if (!_logRing.pending(r) && !_logDropPending[num]) continue;
+
+        uint32_t dropped;
+        size_t n = _logRing.peek(r, lines, cap, dropped);
+        _logDropPending[num] += dropped;
+        _logDropped += dropped;
+
+        char* start = lines;
+        if (_logDropPending[num]) {
+            char mark[MARK_SIZE];
+            int m = snprintf(mark, sizeof(mark), "... %lu log lines dropped\n",
+                             (unsigned long)_logDropPending[num]);
+            start -= m;
+            memcpy(start, mark, m);
+        }
+        // Строки в кадре разделены '\n', последний перевод строки не нужен
+        size_t len = lines + n - start;
+        if (len && start[len - 1] == '\n') len--;
+        start[len] = '\0';
+
+        // sendTXT блокирует, пока кадр не уйдёт в TCP; false — клиент не принял.
+        // Тогда курсор не двигается: повтор на следующем проходе, а если кольцо
+        // успеет его обогнать — потерянные строки посчитает peek()
+        if (!_wsServer.sendTXT(num, start, len)) continue;
+        if (n) _logRing.commit(r, n);
+        _logDropPending[num] = 0;
+        _logFrames++;
+    }
+}
+
+void WeatherWebServer::pushSample() {
+    // Подписчиков нет — и собирать нечего
+    if (_wsServer.connectedClients() == 0) return;
+
+    CpuFreq::Boost boost;
+    size_t len = writeSnapshot(true);
+    if (!len) return;
+    _wsServer.broadcastTXT(_pushBuf, len);
+    _pushCount++;
+}
+
+// Типизированное сообщение: логи идут по тому же сокету простым текстом,
+// страница отличает снимок по префиксу {"t":
+size_t WeatherWebServer::writeSnapshot(bool withPoint) {
+    JsonWriter w(_pushBuf, sizeof(_pushBuf));
+    w.beginObject();
+    w.key("t").str("sample");
+
+    // То же тело, что отдаёт /data (и тот же кэш)
+    if (_sensor->isValid()) {
+        refreshDataCache();
+        w.key("data").raw(_dataCache, _dataCacheLen);
+    }
+
+    // Только то, что меняется от замера к замеру; остальное страница
+    // берёт одним GET /stats при подключении сокета
+    w.key("stats").beginObject();
+    writeLiveStats(w);
+    w.endObject();
+
+    // Последняя сырая точка с тем же округлением, что в /history; gen —
+    // чтобы страница не добавила точку, которая уже пришла с /history
+    int count = _sensor->getTierCount(HistoryTier::RAW);
+    PackedBucket b;
+    if (withPoint && count > 0 && _sensor->getTierBucket(HistoryTier::RAW, count - 1, b)) {
+        w.key("point").beginObject();
+        w.key("gen").num(_sensor->getTierGeneration(HistoryTier::RAW));
+        w.key("temp").centi(b.tempMean, 1);
+        w.key("humid").centi(b.humidMean, 1);
+        w.key("dew").centi(b.dew, 1);
+        w.key("heat").centi(b.heat, 1);
+        w.endObject();
+    }
+
+    w.endObject();
+    if (w.overflow()) {
+        // Обрезанный JSON страница не разберёт — не шлём, но и не молчим
+        _pushOverflows++;
+        LOG_E("ws", "Snapshot exceeds WS_PUSH_BUFFER_SIZE (%u B), not sent",
+              (unsigned)sizeof(_pushBuf));
+        return 0;
+    }
+    return w.length();
 }
 
 void WeatherWebServer::setCORSHeaders() {
     _server.sendHeader("Access-Control-Allow-Origin", "*");
     _server.sendHeader("Access-Control-Allow-Methods", "GET, POST, OPTIONS");
-    _server.sendHeader("Access-Control-Allow-Headers", "Content-Type");
+    _server.sendHeader("Access-Control-Allow-Headers", "Content-Type, If-None-Match");
+    _server.sendHeader("Access-Control-Expose-Headers", "ETag");
+}
+
+bool WeatherWebServer::notModified(const char* etag, const char* cacheControl) {
+    // no-cache (а не no-store): браузер хранит ответ, но каждый раз
+    // переспрашивает с If-None-Match — тело идёт по радио, только если изменилось
+    _server.sendHeader("ETag", etag);
+    _server.sendHeader("Cache-Control", cacheControl);
+
+    // Клиент может прислать список тегов или W/-префикс — ищем вхождение
+    if (!_server.hasHeader("If-None-Match")) return false;
+    if (strstr(_server.header("If-None-Match").c_str(), etag) == nullptr) return false;
+
+    _notModifiedCount++;
+    setCORSHeaders();
+    _server.send(304);
+    return true;
 }
 
 void WeatherWebServer::handleRoot() {
     _requestCount++;
-    _server.send_P(200, "text/html", HTML_PAGE);
+
+    // Страница меняется только с прошивкой: сутки браузер берёт её из кэша
+    // без запроса, потом переспрашивает по ETag (хэш сжатого содержимого).
+    // Годовой immutable здесь нельзя — URL "/" хэша не содержит, и после
+    // перепрошивки вкладки держались бы за старую страницу.
+    if (notModified(HTML_PAGE_ETAG, "public, max-age=86400")) return;
+
+    // Gzip готов ещё при сборке: ~14 КБ вместо ~55 КБ по радио, чип
+    // ничего не сжимает. Accept-Encoding не проверяем — gzip понимают все браузеры.
+    _server.sendHeader("Content-Encoding", "gzip");
+    _server.send_P(200, "text/html", reinterpret_cast<PGM_P>(HTML_PAGE_GZ), HTML_PAGE_GZ_SIZE);
 }
 
 void WeatherWebServer::handleData() {
@@ -109,46 +279,76 @@ void WeatherWebServer::handleData() {
         return;
     }
     
-    float temp = _sensor->getTemperature();
-    float humid = _sensor->getHumidity();
-    
-    float dewPoint = WeatherCalculations::calculateDewPoint(temp, humid);
-    float heatIndex = WeatherCalculations::calculateHeatIndex(temp, humid);
-    
-    // Формирование JSON
-    String json;
-    json.reserve(512);
-    
-    json = "{";
-    json += "\"temperature\":" + String(temp, 2);
-    json += ",\"humidity\":" + String(humid, 2);
-    json += ",\"minTemp\":" + String(_sensor->getMinTemp(), 2);
-    json += ",\"maxTemp\":" + String(_sensor->getMaxTemp(), 2);
-    json += ",\"minHumid\":" + String(_sensor->getMinHumid(), 2);
-    json += ",\"maxHumid\":" + String(_sensor->getMaxHumid(), 2);
-    json += ",\"avgTemp\":" + String(_sensor->getAvgTemp(), 2);
-    json += ",\"avgHumid\":" + String(_sensor->getAvgHumid(), 2);
-    json += ",\"dewPoint\":" + String(dewPoint, 2);
-    json += ",\"heatIndex\":" + String(heatIndex, 2);
-    json += ",\"timestamp\":" + String(millis());
-    json += "}";
-    
+    // Тело меняется только с новым чтением — между ними отдаём готовое,
+    // а клиенту с тем же ETag не отдаём вовсе
+    uint32_t generation = _sensor->getGeneration();
+    char etag[24];
+    snprintf(etag, sizeof(etag), "\"%08lx-d%lu\"",
+             (unsigned long)_bootId, (unsigned long)generation);
+    if (notModified(etag)) return;
+
+    if (refreshDataCache()) _cacheMisses++;
+    else                    _cacheHits++;
+
     setCORSHeaders();
-    _server.sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-    _server.send(200, "application/json", json);
+    _server.send_P(200, "application/json", _dataCache, _dataCacheLen);
+}
+
+bool WeatherWebServer::refreshDataCache() {
+    uint32_t generation = _sensor->getGeneration();
+    if (_dataCacheLen != 0 && _dataCacheGen == generation) return false;
+
+    uint32_t allocs0 = AllocCounter::count();
+
+    JsonWriter w(_dataCache, sizeof(_dataCache));
+    w.beginObject();
+    w.key("temperature").fixed(_sensor->getTemperature(), 2);
+    w.key("humidity").fixed(_sensor->getHumidity(), 2);
+    w.key("minTemp").fixed(_sensor->getMinTemp(), 2);
+    w.key("maxTemp").fixed(_sensor->getMaxTemp(), 2);
+    w.key("minHumid").fixed(_sensor->getMinHumid(), 2);
+    w.key("maxHumid").fixed(_sensor->getMaxHumid(), 2);
+    w.key("avgTemp").fixed(_sensor->getAvgTemp(), 2);
+    w.key("avgHumid").fixed(_sensor->getAvgHumid(), 2);
+    w.key("dewPoint").fixed(_sensor->getDewPoint(), 2);
+    w.key("heatIndex").fixed(_sensor->getHeatIndex(), 2);
+    // Время измерения, а не запроса — иначе кэшировать было бы нечего
+    w.key("timestamp").num(_sensor->getLastReadTime());
+    w.endObject();
+
+    _dataCacheLen = w.length();
+    _dataCacheGen = generation;
+    _bodyAllocsData = AllocCounter::count() - allocs0;
+    return true;
 }
 
 void WeatherWebServer::handleStats() {
     _requestCount++;
     
+    // Тело растёт с профилем, зависаниями и историей загрузок — стримим
+    // chunked, как /history: ответ не обрежется, а на стеке только окно
+    setCORSHeaders();
+    _server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    _server.send(200, "application/json", "");
+
+    uint32_t allocs0 = AllocCounter::count();
+    _allocsInSink = 0;
+
+    char buf[STATS_CHUNK_SIZE];
+    JsonWriter w(buf, sizeof(buf), sendChunk, this);
+    writeStats(w);
+    w.flush();
+
+    _bodyAllocsStats = AllocCounter::count() - allocs0 - _allocsInSink;
+    _server.sendContent("");   // Завершающий нулевой чанк
+}
+
+void WeatherWebServer::writeLiveStats(JsonWriter& w) {
     uint32_t freeHeap = ESP.getFreeHeap();
     uint32_t totalHeap = ESP.getHeapSize();
     uint32_t usedHeap = totalHeap - freeHeap;
     float heapUsagePercent = (float)usedHeap / totalHeap * 100.0;
     
-    String json;
-    json.reserve(768);  // Увеличено для данных батареи
-    
     // Chip temperature (ESP32-C3 supports internal sensor)
     #ifdef SOC_TEMP_SENSOR_SUPPORTED
     float chipTemp = temperatureRead();
@@ -156,108 +356,391 @@ void WeatherWebServer::handleStats() {
     float chipTemp = -1;
     #endif
 
-    json = "{";
-    json += "\"uptime\":\"" + getUptimeString() + "\"";
-    json += ",\"freeHeap\":\"" + formatBytes(freeHeap) + "\"";
-    json += ",\"freeHeapRaw\":" + String(freeHeap);
-    json += ",\"totalHeapRaw\":" + String(totalHeap);
-    json += ",\"heapUsagePct\":" + String(heapUsagePercent, 1);
-    json += ",\"heapUsage\":\"" + String(heapUsagePercent, 1) + "%\"";
-    json += ",\"cpuUsage\":\"" + String(getCPUUsage(), 1) + "\"";
+    // Строковые поля собираем в маленькие буферы на стеке
+    char text[32];
+
+    formatUptime(text, sizeof(text));
+    w.key("uptime").str(text);
+    formatBytes(freeHeap, text, sizeof(text));
+    w.key("freeHeap").str(text);
+    w.key("freeHeapRaw").num(freeHeap);
+    w.key("totalHeapRaw").num(totalHeap);
+    w.key("heapUsagePct").fixed(heapUsagePercent, 1);
+    size_t n = JsonWriter::formatFixed(text, heapUsagePercent, 1);
+    text[n++] = '%';
+    text[n] = '\0';
+    w.key("heapUsage").str(text);
+    JsonWriter::formatFixed(text, getCPUUsage(), 1);
+    w.key("cpuUsage").str(text);
     if (chipTemp > 0) {
-        json += ",\"chipTemp\":" + String(chipTemp, 1);
+        w.key("chipTemp").fixed(chipTemp, 1);
     }
-    json += ",\"ssid\":\"" + _wifi->getSSID() + "\"";
-    json += ",\"rssi\":\"" + String(_wifi->getRSSI()) + "\"";
-    json += ",\"ip\":\"" + _wifi->getIP() + "\"";
-    json += ",\"requests\":" + String(_requestCount);
-    json += ",\"errors\":" + String(_sensor->getReadErrorCount());
-    
+    JsonWriter::formatInt(text, _wifi->getRSSI());
+    w.key("rssi").str(text);
+
     // ═══════════════════════════════════════════════════════
     // Добавление данных о батарее
     // ═══════════════════════════════════════════════════════
-    json += ",\"battery\":{";
-    json += "\"voltage\":" + String(_battery->getVoltage(), 2);
-    json += ",\"percent\":" + String(_battery->getPercent());
-    json += ",\"status\":\"" + _battery->getStatusString() + "\"";
-    json += ",\"source\":\"" + _battery->getPowerSourceString() + "\"";
-    json += ",\"isCharging\":" + String(_battery->isCharging() ? "true" : "false");
-    json += ",\"isUsb\":" + String(_battery->isUsbConnected() ? "true" : "false");
-    json += ",\"isLow\":" + String(_battery->isLowBattery() ? "true" : "false");
-    json += ",\"isCritical\":" + String(_battery->isCriticalBattery() ? "true" : "false");
-    json += "}";
-    
-    json += "}";
-    
-    setCORSHeaders();
-    _server.send(200, "application/json", json);
+    w.key("battery").beginObject();
+    w.key("voltage").fixed(_battery->getVoltage(), 2);
+    w.key("percent").num(_battery->getPercent());
+    w.key("status").str(_battery->getStatusName());
+    w.key("source").str(_battery->getPowerSourceName());
+    w.key("isCharging").boolean(_battery->isCharging());
+    w.key("isUsb").boolean(_battery->isUsbConnected());
+    w.key("isLow").boolean(_battery->isLowBattery());
+    w.key("isCritical").boolean(_battery->isCriticalBattery());
+    w.endObject();
+}
+
+void WeatherWebServer::writeStats(JsonWriter& w) {
+    char text[32];
+
+    w.beginObject();
+    writeLiveStats(w);
+    w.key("ssid").str(_wifi->getSSIDName());
+    _wifi->formatIP(text, sizeof(text));
+    w.key("ip").str(text);
+    w.key("requests").num(_requestCount);
+    w.key("errors").num(_sensor->getReadErrorCount());
+
+    // Неблокирующее чтение AHT10: длительность преобразования и сколько
+    // loop() реально простаивал в вызовах датчика
+    w.key("sensor").beginObject();
+    w.key("conversionMs").num(_sensor->getConversionMs());
+    w.key("blockUs").num(_sensor->getLastBlockUs());
+    w.key("maxBlockUs").num(_sensor->getMaxBlockUs());
+    w.endObject();
+
+    // Фазы loop(), мкс с загрузки (или с /reset): где рождаются задержки
+    w.key("loop").beginObject();
+    for (int i = 0; i < (int)LoopPhase::COUNT; i++) {
+        LoopProfiler::Summary s = LoopProfiler::summary((LoopPhase)i);
+        w.key(LoopProfiler::name((LoopPhase)i)).beginObject();
+        w.key("min").num(s.minUs);
+        w.key("p50").num(s.p50Us);
+        w.key("p99").num(s.p99Us);
+        w.key("max").num(s.maxUs);
+        w.endObject();
+    }
+    w.endObject();
+
+    // Зависания loop() дольше LOOP_STALL_THRESHOLD_MS: всего и последние
+    // с самой долгой фазой и обстановкой на тот момент
+    w.key("stalls").beginObject();
+    w.key("count").num(LoopProfiler::stallCount());
+    w.key("thresholdMs").num(LOOP_STALL_THRESHOLD_MS);
+    w.key("recent").beginArray();
+    for (size_t i = 0; i < LoopProfiler::recentStalls(); i++) {
+        const LoopProfiler::Stall& s = LoopProfiler::stall(i);
+        w.beginObject();
+        w.key("at").num(s.atMs);
+        w.key("us").num(s.totalUs);
+        w.key("phase").str(LoopProfiler::name(s.phase));
+        w.key("phaseUs").num(s.phaseUs);
+        w.key("ws").num(s.wsClients);
+        w.key("wifi").str(s.wifi);
+        w.endObject();
+    }
+    w.endArray();
+    w.endObject();
+
+    // Частота CPU (cpu_freq.h): в простое, число переключений и время
+    // на каждом уровне с загрузки
+    w.key("clock").beginObject();
+    w.key("idleMhz").num(CpuFreq::idleMhz());
+    w.key("switches").num(CpuFreq::switches());
+    w.key("levels").beginArray();
+    for (int i = 0; i < CpuFreq::LEVELS; i++) {
+        w.beginObject();
+        w.key("mhz").num(CpuFreq::levelMhz(i));
+        w.key("ms").num((uint32_t)(CpuFreq::levelUs(i) / 1000));
+        w.endObject();
+    }
+    w.endArray();
+    w.endObject();
+
+    // Вехи загрузки (boot_timeline.h), мс от старта; ещё не пройденные
+    // не выводятся. history — последние загрузки из RTC-памяти, свежая
+    // первой: мкс на этап в порядке stages (0 — этап не завершился).
+    w.key("boot").beginObject();
+    for (int i = 0; i < (int)BootMark::COUNT; i++) {
+        uint32_t at = BootTimeline::at((BootMark)i);
+        if (at) w.key(BootTimeline::name((BootMark)i)).num(at);
+    }
+    w.key("stages").beginArray();
+    for (int i = 0; i < (int)BootStage::COUNT; i++)
+        w.str(BootTimeline::name((BootStage)i));
+    w.endArray();
+    w.key("history").beginArray();
+    for (size_t i = 0; i < BootTimeline::recentBoots(); i++) {
+        const BootRecord& r = BootTimeline::boot(i);
+        w.beginObject();
+        w.key("n").num(r.boot);
+        w.key("reason").str(BootTimeline::reasonName(r.reason));
+        w.key("fw").str(r.fw);
+        w.key("us").beginArray();
+        for (int j = 0; j < (int)BootStage::COUNT; j++) w.num(r.us[j]);
+        w.endArray();
+        w.endObject();
+    }
+    w.endArray();
+    w.endObject();
+
+    // Duty cycle (duty_cycle.h): пробуждения только ради датчика, сколько
+    // замеров ждёт сброса в RTC, удачные сбросы и цена одного пробуждения
+    w.key("duty").beginObject();
+    w.key("enabled").boolean(DUTY_CYCLE_ON_BATTERY);
+    w.key("wakes").num(DutyCycle::wakes());
+    w.key("buffered").num((uint32_t)DutyCycle::count());
+    w.key("capacity").num(DUTY_CYCLE_BUFFER);
+    w.key("flushes").num(DutyCycle::flushes());
+    w.key("dropped").num(DutyCycle::dropped());
+    w.key("awakeUs").num(DutyCycle::lastAwakeUs());
+    w.endObject();
+
+    // Кэш тел /data и /history?tier=raw: попадания — отданы без пересборки;
+    // notModified — ответы 304 на If-None-Match (/, /data, /history)
+    w.key("cache").beginObject();
+    w.key("hits").num(_cacheHits);
+    w.key("misses").num(_cacheMisses);
+    w.key("notModified").num(_notModifiedCount);
+    w.endObject();
+
+    // WS-снимки вместо опросов: подписчики, сколько кадров разослано
+    // и сколько не ушло, потому что не влезло в WS_PUSH_BUFFER_SIZE
+    w.key("push").beginObject();
+    w.key("clients").num(_wsServer.connectedClients());
+    w.key("sent").num(_pushCount);
+    w.key("overflows").num(_pushOverflows);
+    w.endObject();
+
+    // WS-лог: строк принято, кадров отправлено, строк потеряно отставшими клиентами
+    w.key("logs").beginObject();
+    w.key("lines").num(_logRing.lines());
+    w.key("frames").num(_logFrames);
+    w.key("dropped").num(_logDropped);
+    w.endObject();
+
+    // Выделения кучи при сборке тела последнего ответа каждого маршрута —
+    // только проход JsonWriter. Разбор запроса, заголовки и отправка
+    // (WebServer, lwIP) не в счёт: это не «обработчик без выделений».
+    // Для /stats — предыдущий запрос: текущий ещё не дописан.
+    if (AllocCounter::enabled()) {
+        w.key("bodyAllocs").beginObject();
+        w.key("data").num(_bodyAllocsData);
+        w.key("stats").num(_bodyAllocsStats);
+        w.key("history").num(_bodyAllocsHistory);
+        w.key("log").num(Logger::allocs());
+        w.endObject();
+    }
+
+    w.endObject();
 }
 
 void WeatherWebServer::handleHistory() {
     _requestCount++;
-    
-    float tempHist[HISTORY_SIZE];
-    float humidHist[HISTORY_SIZE];
-    
-    _sensor->getHistory(tempHist, humidHist, HISTORY_SIZE);
-    int count = _sensor->getHistoryCount();
 
-    String json;
-    json.reserve(HISTORY_BUFFER_SIZE);
-    
+    // ?tier=raw (по умолчанию) | 5m | 1h
+    HistoryTier tier = HistoryTier::RAW;
+    const char* tierName = "raw";
+    if (_server.hasArg("tier")) {
+        String t = _server.arg("tier");
+        if (t == "5m") {
+            tier = HistoryTier::MIN5;
+            tierName = "5m";
+        } else if (t == "1h") {
+            tier = HistoryTier::HOURLY;
+            tierName = "1h";
+        } else if (t != "raw") {
+            setCORSHeaders();
+            _server.send(400, "application/json",
+                         "{\"error\":\"Unknown tier (raw, 5m, 1h)\",\"code\":400}");
+            return;
+        }
+    }
+
+    int  count    = _sensor->getTierCount(tier);
+    long stepSec  = (long)(SensorManager::getTierStep(tier) / 1000);
+    bool rollup   = tier != HistoryTier::RAW;
+
+    char etag[32];
+    snprintf(etag, sizeof(etag), "\"%08lx-%s%lu\"", (unsigned long)_bootId, tierName,
+             (unsigned long)_sensor->getTierGeneration(tier));
+    if (notModified(etag)) return;
+
+    // Сырой ряд — самый частый запрос дашборда и целиком влезает в кэш:
+    // собираем его один раз на поколение, потом только отправляем
+    if (tier == HistoryTier::RAW) {
+        uint32_t generation = _sensor->getGeneration();
+        if (_historyCacheLen == 0 || _historyCacheGen != generation) {
+            uint32_t allocs0 = AllocCounter::count();
+
+            JsonWriter w(_historyCache, sizeof(_historyCache));
+            writeHistory(w, tier, tierName, count, stepSec, rollup);
+
+            // Не влезло (не должно при HISTORY_CACHE_SIZE) — стримим ниже
+            _historyCacheLen = w.overflow() ? 0 : w.length();
+            _historyCacheGen = generation;
+            _cacheMisses++;
+            _bodyAllocsHistory = AllocCounter::count() - allocs0;
+        } else {
+            _cacheHits++;
+        }
+
+        if (_historyCacheLen) {
+            setCORSHeaders();
+            _server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+            _server.send(200, "application/json", "");
+            _server.sendContent(_historyCache, _historyCacheLen);
+            _server.sendContent("");   // Завершающий нулевой чанк
+            return;
+        }
+    }
+
+    // Chunked transfer: длина заранее не нужна, поэтому ответ пишется за
+    // один проход через буфер фиксированного размера и сливается в сокет
+    // по мере заполнения. Пиковая память не зависит ни от числа точек,
+    // ни от числа рядов.
+    setCORSHeaders();
+    _server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    _server.send(200, "application/json", "");
+
+    // Считаются только выделения при сборке тела; сам сетевой стек
+    // (заголовки, pbuf внутри sendContent) сюда не входит
+    uint32_t allocs0 = AllocCounter::count();
+    _allocsInSink = 0;
+
+    char buf[HISTORY_CHUNK_SIZE];
+    JsonWriter w(buf, sizeof(buf), sendChunk, this);
+    writeHistory(w, tier, tierName, count, stepSec, rollup);
+    w.flush();
+
+    _bodyAllocsHistory = AllocCounter::count() - allocs0 - _allocsInSink;
+    _server.sendContent("");   // Завершающий нулевой чанк
+}
+
+// Sink для JsonWriter: очередной чанк ответа прямо в сокет
+void WeatherWebServer::sendChunk(void* ctx, const char* data, size_t len) {
+    WeatherWebServer* self = static_cast<WeatherWebServer*>(ctx);
+    uint32_t allocs0 = AllocCounter::count();
+    self->_server.sendContent(data, len);
+    self->_allocsInSink += AllocCounter::count() - allocs0;
+}
+
+void WeatherWebServer::writeHistory(JsonWriter& w, HistoryTier tier, const char* tierName,
+                                    int count, long stepSec, bool rollup) {
+    // Точки берутся по одной через getTierBucket(): сотни корзин
+    // на стеке loop-задачи (8 КБ) не поместились бы. Значения — в сотых,
+    // как хранятся: centi() печатает их целой арифметикой, без float
+    PackedBucket b;
+    char label[16];
+
+    w.beginObject();
+    w.key("tier").str(tierName);
+    w.key("step").num(stepSec);
+    w.key("gen").num(_sensor->getTierGeneration(tier));
+
     // Метки времени — время относительно текущего момента (uptime-based, т.к. RTC нет)
     // БАГФИКС: раньше было (SENSOR_INTERVAL / 60000) — при интервале 30с это
     // целочисленный 0, и ВСЕ метки становились "now". Считаем в секундах.
-    json = "{\"labels\":[";
+    w.key("labels").beginArray();
     for (int i = 0; i < count; i++) {
-        if (i > 0) json += ",";
-        long secondsAgo = (long)(count - 1 - i) * (long)(SENSOR_INTERVAL / 1000);
-        if (secondsAgo == 0) {
-            json += "\"now\"";
-        } else if (secondsAgo < 60) {
-            json += "\"-" + String(secondsAgo) + "s\"";
-        } else if (secondsAgo % 60 == 0) {
-            json += "\"-" + String(secondsAgo / 60) + "m\"";
-        } else {
-            json += "\"-" + String(secondsAgo / 60.0f, 1) + "m\"";
-        }
+        long secondsAgo = (long)(count - 1 - i) * stepSec;
+        formatAgo(secondsAgo, label, sizeof(label));
+        w.str(label);
     }
-    
-    json += "],\"temp\":[";
+    w.endArray();
+
+    // Для свёрток temp/humid — средние за корзину, min/max идут отдельно
+    w.key("temp").beginArray();
     for (int i = 0; i < count; i++) {
-        if (i > 0) json += ",";
-        json += String(tempHist[i], 1);
+        _sensor->getTierBucket(tier, i, b);
+        w.centi(b.tempMean, 1);
     }
-    
-    json += "],\"humid\":[";
+    w.endArray();
+
+    w.key("humid").beginArray();
     for (int i = 0; i < count; i++) {
-        if (i > 0) json += ",";
-        json += String(humidHist[i], 1);
+        _sensor->getTierBucket(tier, i, b);
+        w.centi(b.humidMean, 1);
     }
-    
-    // Dew point and heat index calculated server-side (same formulas as /data)
-    json += "],\"dew\":[";
+    w.endArray();
+
+    // Dew point and heat index are precomputed once per sample in SensorManager
+    w.key("dew").beginArray();
     for (int i = 0; i < count; i++) {
-        if (i > 0) json += ",";
-        json += String(WeatherCalculations::calculateDewPoint(tempHist[i], humidHist[i]), 1);
+        _sensor->getTierBucket(tier, i, b);
+        w.centi(b.dew, 1);
     }
-    
-    json += "],\"heat\":[";
+    w.endArray();
+
+    w.key("heat").beginArray();
     for (int i = 0; i < count; i++) {
-        if (i > 0) json += ",";
-        json += String(WeatherCalculations::calculateHeatIndex(tempHist[i], humidHist[i]), 1);
+        _sensor->getTierBucket(tier, i, b);
+        w.centi(b.heat, 1);
+    }
+    w.endArray();
+
+    if (rollup) {
+        w.key("tempMin").beginArray();
+        for (int i = 0; i < count; i++) {
+            _sensor->getTierBucket(tier, i, b);
+            w.centi(b.tempMin, 1);
+        }
+        w.endArray();
+
+        w.key("tempMax").beginArray();
+        for (int i = 0; i < count; i++) {
+            _sensor->getTierBucket(tier, i, b);
+            w.centi(b.tempMax, 1);
+        }
+        w.endArray();
+
+        w.key("humidMin").beginArray();
+        for (int i = 0; i < count; i++) {
+            _sensor->getTierBucket(tier, i, b);
+            w.centi(b.humidMin, 1);
+        }
+        w.endArray();
+
+        w.key("humidMax").beginArray();
+        for (int i = 0; i < count; i++) {
+            _sensor->getTierBucket(tier, i, b);
+            w.centi(b.humidMax, 1);
+        }
+        w.endArray();
+    }
+
+    w.endObject();
+}
+
+// "now", "-45s", "-12m", "-7.5m", "-23h", "-23h55m"
+void WeatherWebServer::formatAgo(long secondsAgo, char* out, size_t len) {
+    if (secondsAgo == 0) {
+        snprintf(out, len, "now");
+    } else if (secondsAgo < 60) {
+        snprintf(out, len, "-%lds", secondsAgo);
+    } else if (secondsAgo >= 7200) {
+        // Свёртки уходят на сутки и дальше — минуты там уже не читаются
+        if (secondsAgo % 3600)
+            snprintf(out, len, "-%ldh%ldm", secondsAgo / 3600, (secondsAgo % 3600) / 60);
+        else
+            snprintf(out, len, "-%ldh", secondsAgo / 3600);
+    } else if (secondsAgo % 60 == 0) {
+        snprintf(out, len, "-%ldm", secondsAgo / 60);
+    } else {
+        // Дробные минуты с одним знаком — в целых: 450 с → "7.5"
+        long tenths = secondsAgo / 6;
+        snprintf(out, len, "-%ld.%ldm", tenths / 10, tenths % 10);
     }
-    
-    json += "]}";
-    
-    setCORSHeaders();
-    _server.send(200, "application/json", json);
 }
 
 void WeatherWebServer::handleReset() {
     _requestCount++;
     
     _sensor->resetMinMax();
+    LoopProfiler::reset();
     
     setCORSHeaders();
     _server.send(200, "application/json", 
@@ -288,7 +771,7 @@ void WeatherWebServer::handleNotFound() {
     _server.send(404, "text/plain", message);
 }
 
-String WeatherWebServer::getUptimeString() const {
+void WeatherWebServer::formatUptime(char* out, size_t len) const {
     unsigned long uptime = (millis() - _bootTime) / 1000;
     
     int days = uptime / 86400;
@@ -296,23 +779,23 @@ String WeatherWebServer::getUptimeString() const {
     int minutes = (uptime % 3600) / 60;
     int seconds = uptime % 60;
     
-    char buffer[32];
     if (days > 0) {
-        snprintf(buffer, sizeof(buffer), "%dd %02d:%02d:%02d", days, hours, minutes, seconds);
+        snprintf(out, len, "%dd %02d:%02d:%02d", days, hours, minutes, seconds);
     } else {
-        snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d", hours, minutes, seconds);
+        snprintf(out, len, "%02d:%02d:%02d", hours, minutes, seconds);
     }
-    
-    return String(buffer);
 }
 
-String WeatherWebServer::formatBytes(size_t bytes) const {
+void WeatherWebServer::formatBytes(size_t bytes, char* out, size_t len) const {
+    // Дробная часть — в целых, без float printf
     if (bytes < 1024) {
-        return String(bytes) + " B";
+        snprintf(out, len, "%u B", (unsigned)bytes);
     } else if (bytes < 1024 * 1024) {
-        return String(bytes / 1024.0, 1) + " KB";
+        unsigned tenths = (unsigned)((bytes * 10 + 512) / 1024);
+        snprintf(out, len, "%u.%u KB", tenths / 10, tenths % 10);
     } else {
-        return String(bytes / (1024.0 * 1024.0), 2) + " MB";
+        unsigned hundredths = (unsigned)(((uint64_t)bytes * 100 + 524288) / 1048576);
+        snprintf(out, len, "%u.%02u MB", hundredths / 100, hundredths % 100);
     }
 }
 
@@ -323,3 +806,7 @@ float WeatherWebServer::getCPUUsage() const {
 unsigned long WeatherWebServer::getRequestCount() const {
     return _requestCount;
 }
+
+uint8_t WeatherWebServer::getClientCount() {
+    return _wsServer.connectedClients();
+}
@@ -7,6 +7,8 @@
 #include "wifi_manager.h"
 #include "battery_manager.h"
 #include "calculations.h"
+#include "json_writer.h"
+#include "log_ring.h"
 
 class WeatherWebServer {
 public:
@@ -14,10 +16,21 @@ public:
     
     void begin();
     void handleClient();
+
+    // Строка в WS-лог. Не отправляет сразу: копит в кольце, handleClient()
+    // раз за проход отдаёт каждому клиенту всё накопленное одним кадром.
     void broadcastLog(const String& message);
+    void broadcastLog(const char* message);
+    void broadcastLog(const char* message, size_t len);
+
+    // Снимок /data + /stats + новая точка истории — всем WS-клиентам одним
+    // кадром. Зовётся на каждое принятое чтение; дашборд с живым WS
+    // перестаёт опрашивать /data, /stats и /history.
+    void pushSample();
     
     // Статистика
     unsigned long getRequestCount() const;
+    uint8_t getClientCount();   // Подключённых WS-клиентов
     
 private:
     WebServer _server;
@@ -27,6 +40,45 @@ private:
     BatteryManager* _battery;
     unsigned long _bootTime;
     unsigned long _requestCount;
+
+    // Выделения кучи при сборке тела последнего ответа (см. AllocCounter):
+    // только проход JsonWriter, без разбора запроса и отправки
+    uint32_t _bodyAllocsData;
+    uint32_t _bodyAllocsStats;
+    uint32_t _bodyAllocsHistory;
+    uint32_t _allocsInSink;   // Из них — внутри sendContent(), вычитаются
+
+    // Готовые тела /data и /history?tier=raw. Пересобираются, только когда
+    // у SensorManager сменилось поколение; повторный опрос — одна отправка
+    // буфера в сокет. Длина 0 — кэш пуст.
+    char     _dataCache[DATA_JSON_BUFFER_SIZE];
+    size_t   _dataCacheLen;
+    uint32_t _dataCacheGen;
+    char     _historyCache[HISTORY_CACHE_SIZE];
+    size_t   _historyCacheLen;
+    uint32_t _historyCacheGen;
+    unsigned long _cacheHits;
+    unsigned long _cacheMisses;
+
+    // Условные GET: ETag = "<загрузка>-<маршрут><поколение>". Номер загрузки
+    // случайный, чтобы после перезагрузки поколение 1 не совпало со старым.
+    // Для страницы — хэш сжатого HTML из сборки (HTML_PAGE_ETAG).
+    uint32_t      _bootId;
+    unsigned long _notModifiedCount;
+    unsigned long _pushCount;       // WS-снимков разослано
+    unsigned long _pushOverflows;   // Не влезли в _pushBuf и не ушли
+    // Буфер снимка: 2 КБ на стеке loop-задачи (тем более внутри колбэка
+    // _wsServer.loop()) — слишком много, держим его в объекте
+    char          _pushBuf[WS_PUSH_BUFFER_SIZE];
+
+    // WS-лог: общее кольцо строк, у каждого клиента свой курсор в нём.
+    // Клиент, не принявший кадр, остаётся на месте; если кольцо его
+    // обгонит — старые строки теряются, и он получает отметку о пропуске.
+    LogRing<LOG_RING_SIZE>         _logRing;
+    LogRing<LOG_RING_SIZE>::Reader _logReaders[WEBSOCKETS_SERVER_CLIENT_MAX];
+    uint32_t      _logDropPending[WEBSOCKETS_SERVER_CLIENT_MAX];
+    unsigned long _logFrames;    // Кадров лога отправлено
+    unsigned long _logDropped;   // Строк потеряно (по всем клиентам)
     
     // Обработчики маршрутов
     void handleRoot();
@@ -39,12 +91,30 @@ private:
     
     // WebSocket event handler
     void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length);
+    void flushLogs();
     
-    // Вспомогательные функции
-    String getUptimeString() const;
-    String formatBytes(size_t bytes) const;
+    // Тела ответов: общие для HTTP и WS-снимков
+    bool   refreshDataCache();   // true — тело /data пришлось пересобрать
+    void   writeStats(JsonWriter& w);       // Всё тело /stats
+    // Поля /stats, что меняются с каждым замером (память, CPU, RSSI,
+    // батарея), без скобок объекта — их и кладёт WS-снимок
+    void   writeLiveStats(JsonWriter& w);
+    size_t writeSnapshot(bool withPoint);   // В _pushBuf; 0 — не влез
+
+    // /history и /stats: тело стримится chunked-ответом через буфер-окно
+    void writeHistory(JsonWriter& w, HistoryTier tier, const char* tierName,
+                      int count, long stepSec, bool rollup);
+    static void sendChunk(void* ctx, const char* data, size_t len);
+    static void formatAgo(long secondsAgo, char* out, size_t len);
+
+    // Вспомогательные функции (пишут в буфер вызывающего — без String)
+    void formatUptime(char* out, size_t len) const;
+    void formatBytes(size_t bytes, char* out, size_t len) const;
     float getCPUUsage() const;
     
+    // ETag + Cache-Control. true — копия клиента актуальна, 304 уже отправлен
+    bool notModified(const char* etag, const char* cacheControl = "no-cache");
+
     // CORS headers
     void setCORSHeaders();
 };
@@ -1,77 +1,89 @@
 #include "wifi_manager.h"
 
-WiFiManager::WiFiManager(const char* ssid, const char* password)
+// Метка валидного кэша: нули после холодного старта её не дают
+static constexpr uint32_t WIFI_CACHE_MAGIC = 0x57494649;   // "WIFI"
+
+// FNV-1a: кэш привязан к имени сети
+static uint32_t ssidHash(const char* ssid) {
+    uint32_t h = 2166136261u;
+    for (const char* p = ssid; *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+    return h;
+}
+
+WiFiManager::WiFiManager(const char* ssid, const char* password, WiFiCache* cache)
     : _ssid(ssid),
       _password(password),
       _reconnectCount(0),
       _connectTime(0),
       _reconnecting(false),
-      _reconnectStarted(0) {}
-
-bool WiFiManager::begin() {
-    Serial.println("\n=== WiFi Manager ===");
-    return connectBlocking();
-}
+      _reconnectStarted(0),
+      _cache(cache),
+      _connectPath(""),
+      _connectStarted(0),
+      _connectMs(0),
+      _connectedAtMs(0) {}
 
 // ============================================
-// Первоначальное подключение (блокирующее)
-// Используется ТОЛЬКО в setup() — здесь scan нормален
+// Запуск подключения — НЕ БЛОКИРУЕТ.
+// Ассоциация идёт в фоне, пока setup() поднимает дисплей и датчик;
+// дождётся её checkConnection() из loop(). Сначала — по RTC-кэшу
+// без скана; не вышло за WIFI_FAST_CONNECT_TIMEOUT — обычный WiFi.begin(),
+// где канал ищет сам стек.
 // ============================================
-bool WiFiManager::connectBlocking() {
+void WiFiManager::begin() {
     Serial.printf("Подключение к WiFi: %s\n", _ssid);
 
     WiFi.mode(WIFI_STA);
     WiFi.setSleep(false);
     WiFi.setAutoReconnect(true);
     WiFi.persistent(false);
-    WiFi.disconnect(true);
-    delay(100);
-
-    // Scan только при первоначальном подключении
-    Serial.println("Сканирование WiFi сетей...");
-    int networksFound = WiFi.scanNetworks();
-    Serial.printf("Найдено сетей: %d\n", networksFound);
-
-    bool targetFound = false;
-    for (int i = 0; i < networksFound; i++) {
-        String ssid = WiFi.SSID(i);
-        int rssi = WiFi.RSSI(i);
-        Serial.printf("  %2d: %s (%d dBm) %s\n",
-                      i + 1, ssid.c_str(), rssi,
-                      WiFi.encryptionType(i) == WIFI_AUTH_OPEN ? "[OPEN]" : "");
-        if (ssid == _ssid) {
-            targetFound = true;
-            Serial.printf("  ✓ Целевая сеть найдена! Сигнал: %d dBm\n", rssi);
+
+    _connectStarted = _reconnectStarted = millis();
+    _reconnecting   = true;   // Для loop() первое подключение — тот же реконнект
+    if (cacheValid()) {
+        const uint8_t* b = _cache->bssid;
+        Serial.printf("Быстрое подключение: %02X:%02X:%02X:%02X:%02X:%02X, канал %u\n",
+                      b[0], b[1], b[2], b[3], b[4], b[5], _cache->channel);
+        if (WIFI_CACHE_DHCP_LEASE && _cache->ip) {
+            WiFi.config(IPAddress(_cache->ip), IPAddress(_cache->gateway),
+                        IPAddress(_cache->subnet), IPAddress(_cache->dns));
         }
+        _connectPath = "cached";
+        WiFi.begin(_ssid, _password, _cache->channel, _cache->bssid);
+    } else {
+        _connectPath = "scan";
+        WiFi.begin(_ssid, _password);
     }
-    if (!targetFound)
-        Serial.printf("  ✗ ВНИМАНИЕ: Сеть '%s' не найдена!\n", _ssid);
+}
 
+// Кэш не сработал (AP сменила канал или BSSID) — забываем его и
+// подключаемся как при холодном старте
+void WiFiManager::fallBackToScan() {
+    Serial.printf("✗ Быстрое подключение не удалось за %lu мс — ищем сеть заново\n",
+                  WIFI_FAST_CONNECT_TIMEOUT);
+    _cache->magic = 0;
+    WiFi.disconnect();
+    if (WIFI_CACHE_DHCP_LEASE)
+        WiFi.config(IPAddress(), IPAddress(), IPAddress());   // Снова DHCP
+    _connectPath = "scan";
     WiFi.begin(_ssid, _password);
+}
 
-    Serial.print("Подключение");
-    int attempts = 0;
-    unsigned long startTime = millis();
-    while (WiFi.status() != WL_CONNECTED && attempts < WIFI_MAX_RETRY) {
-        delay(500);
-        Serial.print(".");
-        attempts++;
-        if (millis() - startTime > WIFI_TIMEOUT) {
-            Serial.println("\n✗ Таймаут подключения!");
-            break;
-        }
-    }
-
-    if (WiFi.status() == WL_CONNECTED) {
-        _connectTime = millis();
-        _reconnecting = false;
-        Serial.println("\n✓ WiFi подключен успешно!");
-        printNetworkInfo();
-        return true;
-    }
+bool WiFiManager::cacheValid() const {
+    return _cache && _cache->magic == WIFI_CACHE_MAGIC &&
+           _cache->ssidHash == ssidHash(_ssid) && _cache->channel != 0;
+}
 
-    Serial.println("\n✗ Не удалось подключиться к WiFi");
-    return false;
+void WiFiManager::saveCache() {
+    if (!_cache) return;
+    memcpy(_cache->bssid, WiFi.BSSID(), sizeof(_cache->bssid));
+    _cache->channel  = (uint8_t)WiFi.channel();
+    _cache->ip       = (uint32_t)WiFi.localIP();
+    _cache->gateway  = (uint32_t)WiFi.gatewayIP();
+    _cache->subnet   = (uint32_t)WiFi.subnetMask();
+    _cache->dns      = (uint32_t)WiFi.dnsIP();
+    _cache->ssidHash = ssidHash(_ssid);
+    _cache->magic    = WIFI_CACHE_MAGIC;
 }
 
 // ============================================
@@ -100,18 +112,34 @@ void WiFiManager::checkConnection() {
         return;
     }
 
-    // Ждём завершения неблокирующего реконнекта
+    // Ждём завершения неблокирующего (пере)подключения
     if (WiFi.status() == WL_CONNECTED) {
         _connectTime = now;
         _reconnecting = false;
-        Serial.printf("✓ WiFi переподключён (попытка #%d): %s (%d dBm)\n",
-                      _reconnectCount,
-                      WiFi.SSID().c_str(),
-                      WiFi.RSSI());
+        saveCache();   // AP после реконнекта могла смениться
+        if (_connectedAtMs == 0) {
+            _connectedAtMs = now;
+            _connectMs     = now - _connectStarted;
+            Serial.printf("✓ WiFi подключен успешно! (%s: %lu мс, с загрузки %lu мс)\n",
+                          _connectPath, _connectMs, _connectedAtMs);
+        } else {
+            Serial.printf("✓ WiFi переподключён (попытка #%d): %s (%d dBm)\n",
+                          _reconnectCount,
+                          WiFi.SSID().c_str(),
+                          WiFi.RSSI());
+        }
         printNetworkInfo();
         return;
     }
 
+    // Первое подключение по кэшу: ждём недолго, дальше — без кэша
+    if (_connectedAtMs == 0 && _connectPath[0] == 'c' &&
+        now - _reconnectStarted > WIFI_FAST_CONNECT_TIMEOUT) {
+        _reconnectStarted = now;
+        fallBackToScan();
+        return;
+    }
+
     // Таймаут реконнекта истёк — пробуем ещё раз
     if (now - _reconnectStarted > RECONNECT_TIMEOUT) {
         Serial.printf("✗ Реконнект #%d не удался (таймаут %lu с). Пробуем снова...\n",
@@ -142,6 +170,20 @@ String WiFiManager::getSSID() const {
     return isConnected() ? WiFi.SSID() : "Не подключено";
 }
 
+const char* WiFiManager::getSSIDName() const {
+    // Подключаемся только к _ssid — WiFi.SSID() вернул бы то же, но через String
+    return isConnected() ? _ssid : "Не подключено";
+}
+
+void WiFiManager::formatIP(char* out, size_t len) const {
+    if (!isConnected()) {
+        snprintf(out, len, "Нет подключения");
+        return;
+    }
+    IPAddress ip = WiFi.localIP();
+    snprintf(out, len, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+}
+
 int WiFiManager::getReconnectCount() const {
     return _reconnectCount;
 }
@@ -164,6 +206,18 @@ String WiFiManager::getConnectionStatus() const {
     }
 }
 
+const char* WiFiManager::getStatusName() const {
+    if (_reconnecting) return "reconnecting";
+    switch (WiFi.status()) {
+        case WL_CONNECTED:        return "connected";
+        case WL_NO_SSID_AVAIL:    return "no_ssid";
+        case WL_CONNECT_FAILED:   return "failed";
+        case WL_CONNECTION_LOST:  return "lost";
+        case WL_DISCONNECTED:     return "disconnected";
+        default:                  return "idle";
+    }
+}
+
 void WiFiManager::printNetworkInfo() {
     Serial.println("\n--- Информация о подключении ---");
     Serial.printf("SSID:    %s\n",    WiFi.SSID().c_str());
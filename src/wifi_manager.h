@@ -4,12 +4,24 @@
 #include <WiFi.h>
 #include "config.h"
 
+// Последняя удачная точка доступа. Живёт в RTC-памяти (RTC_DATA_ATTR
+// в main.cpp рядом с g_sleepCycles) и переживает deep sleep: при
+// пробуждении подключаемся сразу по BSSID и каналу, без скана эфира.
+// ssidHash — кэш от другой сети (поменяли WIFI_SSID) не используем.
+struct WiFiCache {
+    uint32_t magic;
+    uint32_t ssidHash;
+    uint8_t  bssid[6];
+    uint8_t  channel;
+    uint32_t ip, gateway, subnet, dns;   // Аренда DHCP (WIFI_CACHE_DHCP_LEASE)
+};
+
 class WiFiManager {
 public:
-    WiFiManager(const char* ssid, const char* password);
+    WiFiManager(const char* ssid, const char* password, WiFiCache* cache = nullptr);
 
-    bool begin();           // Первоначальное подключение (блокирующее — ок в setup)
-    void checkConnection(); // Вызывать в loop() — НЕ блокирует
+    void begin();           // Запуск подключения — НЕ блокирует, ждать не нужно
+    void checkConnection(); // Вызывать в loop() — НЕ блокирует; доводит и первое подключение
     bool isConnected() const;
 
     // Modem sleep: true = экономия энергии (батарея), false = мин. задержка (USB)
@@ -20,11 +32,22 @@ public:
     int getRSSI() const;
     int getChannel() const;
     String getSSID() const;
+    // Без String — для JsonWriter в обработчиках
+    const char* getSSIDName() const;
+    void formatIP(char* out, size_t len) const;
     int getReconnectCount() const;
 
     // Статистика
     unsigned long getUptime() const;
     String getConnectionStatus() const;
+    const char* getStatusName() const;   // "connected", "reconnecting", ... — для JSON
+
+    // Как прошло первое подключение: "cached" (по RTC-кэшу) или "scan",
+    // сколько длилось от begin() и на какой мс от загрузки закончилось
+    // (0 — ещё не подключались)
+    const char*   getConnectPath() const { return _connectPath; }
+    unsigned long getConnectMs() const { return _connectMs; }
+    unsigned long getConnectedAtMs() const { return _connectedAtMs; }
 
 private:
     const char* _ssid;
@@ -37,7 +60,16 @@ private:
     unsigned long _reconnectStarted;
     static constexpr unsigned long RECONNECT_TIMEOUT = 15000; // мс
 
-    bool connectBlocking(); // Только для setup()
+    // Первое подключение
+    WiFiCache*    _cache;
+    const char*   _connectPath;
+    unsigned long _connectStarted;
+    unsigned long _connectMs;
+    unsigned long _connectedAtMs;
+
+    void fallBackToScan();
+    bool cacheValid() const;
+    void saveCache();
     void printNetworkInfo();
 };
 
@@ -62,6 +62,15 @@ class TestRootEndpoint:
         assert "<!DOCTYPE html>" in response.text
         assert "<html" in response.text
         
+    def test_root_is_gzipped(self, session, base_url):
+        """Page should be served precompressed and cacheable"""
+        response = session.get(f"{base_url}/", headers={"Accept-Encoding": "gzip"})
+        
+        assert response.headers.get("Content-Encoding") == "gzip"
+        assert "max-age" in response.headers.get("Cache-Control", "")
+        # requests распаковывает сам — на проводе байт заметно меньше
+        assert int(response.headers["Content-Length"]) < len(response.content)
+    
     def test_root_contains_title(self, session, base_url):
         """HTML should contain page title"""
         response = session.get(f"{base_url}/")
@@ -187,6 +196,96 @@ class TestStatsEndpoint:
         for field in required_fields:
             assert field in data, f"Missing field: {field}"
     
+    def test_json_bodies_do_not_allocate(self, session, base_url):
+        """JSON bodies should be written without heap allocations
+        (the counters cover the JsonWriter pass, not headers or sockets)"""
+        for path in ("/data", "/history"):
+            session.get(f"{base_url}{path}")
+        data = session.get(f"{base_url}/stats").json()
+        
+        if "bodyAllocs" not in data:
+            pytest.skip("Firmware built without ALLOC_COUNTER")
+        for route, count in data["bodyAllocs"].items():
+            assert count == 0, f"{route} body allocated {count} times"
+    
+    def test_cache_counters(self, session, base_url):
+        """Repeated polls between readings should hit the response cache"""
+        before = session.get(f"{base_url}/stats").json()["cache"]
+        session.get(f"{base_url}/data")
+        session.get(f"{base_url}/data")
+        after = session.get(f"{base_url}/stats").json()["cache"]
+        
+        served = (after["hits"] + after["misses"]) - (before["hits"] + before["misses"])
+        assert served == 2
+        assert after["hits"] > before["hits"]
+    
+    def test_loop_profile(self, session, base_url):
+        """Every loop() phase should report ordered latency percentiles"""
+        loop = session.get(f"{base_url}/stats").json()["loop"]
+        
+        for phase in ["button", "battery", "wifi", "web", "display", "sensor", "status"]:
+            p = loop[phase]
+            assert p["min"] <= p["p50"] <= p["p99"] <= p["max"], phase
+    
+    def test_stall_log(self, session, base_url):
+        """Stall records should name a known phase and stay within the ring"""
+        stalls = session.get(f"{base_url}/stats").json()["stalls"]
+        
+        assert stalls["thresholdMs"] > 0
+        assert len(stalls["recent"]) <= stalls["count"]
+        for s in stalls["recent"]:
+            assert s["us"] >= stalls["thresholdMs"] * 1000
+            assert s["phaseUs"] <= s["us"]
+            assert s["phase"] in ["button", "battery", "wifi", "web", "display", "sensor", "status"]
+    
+    def test_cpu_clock_levels(self, session, base_url):
+        """Time at each CPU clock should be reported and cover the uptime"""
+        clock = session.get(f"{base_url}/stats").json()["clock"]
+        
+        mhz = [level["mhz"] for level in clock["levels"]]
+        assert clock["idleMhz"] in mhz
+        assert min(mhz) >= 80  # WiFi and APB need at least 80 MHz
+        assert sum(level["ms"] for level in clock["levels"]) > 0
+        assert clock["switches"] >= 0
+    
+    def test_boot_timeline(self, session, base_url):
+        """Boot milestones should be present once served and in boot order"""
+        boot = session.get(f"{base_url}/stats").json()["boot"]
+        
+        # We got an answer over WiFi, so all of these have happened
+        for field in ["serial", "wifiStart", "setupDone", "wifiConnected",
+                      "banner", "firstHttp"]:
+            assert isinstance(boot[field], int) and boot[field] > 0
+        # WiFi is started before the rest of setup(), not after it
+        assert boot["serial"] <= boot["wifiStart"] <= boot["setupDone"]
+        assert boot["wifiStart"] <= boot["wifiConnected"] <= boot["banner"]
+    
+    def test_boot_history(self, session, base_url):
+        """Per-stage boot times should be kept for the last few boots"""
+        boot = session.get(f"{base_url}/stats").json()["boot"]
+        
+        stages = boot["stages"]
+        assert stages[0] == "setup"
+        assert 1 <= len(boot["history"]) <= 4
+        
+        current = boot["history"][0]
+        assert current["fw"]
+        assert current["reason"] in ["poweron", "ext", "sw", "panic", "wdt",
+                                     "deepsleep", "brownout", "unknown"]
+        assert len(current["us"]) == len(stages)
+        # This boot got through setup() and connected to WiFi
+        us = dict(zip(stages, current["us"]))
+        assert all(v > 0 for v in us.values())
+        assert us["setup"] >= us["serial"] + us["battery"] + us["sensor"]
+    
+    def test_log_counters(self, session, base_url):
+        """WS log batching counters should be exposed and consistent"""
+        logs = session.get(f"{base_url}/stats").json()["logs"]
+        
+        for field in ["lines", "frames", "dropped"]:
+            assert isinstance(logs[field], int) and logs[field] >= 0
+        assert logs["lines"] > 0  # setup() banner is always queued
+    
     def test_battery_fields(self, session, base_url):
         """Battery object should contain required fields"""
         response = session.get(f"{base_url}/stats")
@@ -252,6 +351,16 @@ class TestHistoryEndpoint:
         assert response.status_code == 200
         assert "application/json" in response.headers.get("Content-Type", "")
     
+    def test_history_is_chunked(self, session, base_url):
+        """History should be streamed with chunked transfer encoding"""
+        for tier in ("raw", "5m", "1h"):
+            response = session.get(f"{base_url}/history", params={"tier": tier})
+            
+            assert response.status_code == 200
+            assert response.headers.get("Transfer-Encoding", "").lower() == "chunked"
+            assert "Content-Length" not in response.headers
+            response.json()
+    
     def test_history_structure(self, session, base_url):
         """History should have correct structure"""
         response = session.get(f"{base_url}/history")
@@ -281,8 +390,28 @@ class TestHistoryEndpoint:
         response = session.get(f"{base_url}/history")
         data = response.json()
         
-        # По умолчанию HISTORY_SIZE = 60
-        assert len(data["labels"]) <= 60
+        # По умолчанию HISTORY_SIZE = 120
+        assert len(data["labels"]) <= 120
+
+    @pytest.mark.parametrize("tier,max_size", [("5m", 576), ("1h", 336)])
+    def test_history_tiers(self, session, base_url, tier, max_size):
+        """Rollup tiers should return min/max/mean arrays of equal length"""
+        response = session.get(f"{base_url}/history", params={"tier": tier})
+        assert response.status_code == 200
+        data = response.json()
+        
+        assert data["tier"] == tier
+        n = len(data["labels"])
+        assert n <= max_size
+        for key in ("temp", "humid", "tempMin", "tempMax", "humidMin", "humidMax"):
+            assert len(data[key]) == n
+        for lo, mean, hi in zip(data["tempMin"], data["temp"], data["tempMax"]):
+            assert lo <= mean <= hi
+    
+    def test_history_unknown_tier(self, session, base_url):
+        """Unknown tier should be rejected"""
+        response = session.get(f"{base_url}/history", params={"tier": "1d"})
+        assert response.status_code == 400
 
 # ═══════════════════════════════════════════════════════════════
 # Reset Endpoint Tests
@@ -418,6 +547,43 @@ class TestCORS:
             assert headers["Access-Control-Allow-Origin"] == "*" or \
                    headers["Access-Control-Allow-Origin"] != ""
 
+# ═══════════════════════════════════════════════════════════════
+# Conditional GET Tests
+# ═══════════════════════════════════════════════════════════════
+
+class TestConditionalGet:
+    """ETag / If-None-Match tests"""
+    
+    @pytest.mark.parametrize("path", ["/", "/data", "/history", "/history?tier=5m"])
+    def test_etag_present(self, session, base_url, path):
+        """Cacheable endpoints should send ETag and require revalidation"""
+        response = session.get(f"{base_url}{path}")
+        
+        assert response.status_code == 200
+        assert response.headers.get("ETag", "").startswith('"')
+        assert "no-store" not in response.headers.get("Cache-Control", "")
+    
+    @pytest.mark.parametrize("path", ["/", "/data", "/history"])
+    def test_matching_etag_returns_304(self, session, base_url, path):
+        """Matching If-None-Match should return 304 without a body"""
+        etag = session.get(f"{base_url}{path}").headers["ETag"]
+        response = session.get(f"{base_url}{path}", headers={"If-None-Match": etag})
+        
+        # Между запросами могло прийти новое чтение — тогда новый тег и 200
+        if response.status_code == 200:
+            assert response.headers["ETag"] != etag
+        else:
+            assert response.status_code == 304
+            assert response.headers["ETag"] == etag
+            assert len(response.content) == 0
+    
+    def test_stale_etag_returns_body(self, session, base_url):
+        """Unknown ETag should return the full body"""
+        response = session.get(f"{base_url}/data", headers={"If-None-Match": '"stale"'})
+        
+        assert response.status_code == 200
+        response.json()
+
 # ═══════════════════════════════════════════════════════════════
 # Integration Tests
 # ═══════════════════════════════════════════════════════════════
@@ -0,0 +1,182 @@
+// ============================================
+// Unit-тест и бенчмарк WeatherCalculations
+// ============================================
+// Целочисленные ядра сверяются с исходными float-формулами на всём
+// рабочем диапазоне AHT10, затем обе версии меряются по времени.
+//
+//   pio test -e native          -f test_calculations   # хост: нс на вызов
+//   pio test -e esp32-c3-test   -f test_calculations   # плата: такты CPU на вызов
+
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include "calculations.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+// Допуск к float-версии. Сама float-формула в single precision ошибается
+// на ~0.005 °C на краях диапазона, а в интерфейс уходит 0.1 °C.
+static constexpr float DEW_TOLERANCE  = 0.02f;
+static constexpr float HEAT_TOLERANCE = 0.02f;
+
+void setUp() {}
+void tearDown() {}
+
+// --------------------------------------------
+// Точность
+// --------------------------------------------
+void test_dew_point_matches_float() {
+    float worst = 0;
+    for (int t = -4000; t <= 8500; t += 7) {
+        for (int h = 1; h <= 10000; h += 13) {
+            float ref = WeatherCalculations::dewPointFloat(t / 100.0f, h / 100.0f);
+            float fix = WeatherCalculations::dewPointC100((int16_t)t, (uint16_t)h) / 100.0f;
+            float err = fabsf(fix - ref);
+            if (err > worst) worst = err;
+            if (err > DEW_TOLERANCE) {
+                char msg[96];
+                snprintf(msg, sizeof(msg), "T=%.2f H=%.2f fixed=%.3f float=%.3f",
+                         t / 100.0f, h / 100.0f, fix, ref);
+                TEST_FAIL_MESSAGE(msg);
+            }
+        }
+    }
+    char msg[48];
+    snprintf(msg, sizeof(msg), "dew point max error %.4f C", worst);
+    TEST_MESSAGE(msg);
+}
+
+void test_heat_index_matches_float() {
+    float worst = 0;
+    for (int t = 2700; t <= 8500; t += 3) {
+        for (int h = 0; h <= 10000; h += 11) {
+            float ref = WeatherCalculations::heatIndexFloat(t / 100.0f, h / 100.0f);
+            // Выше ±320 °C формула Ротфуса уже ничего не значит, а int16 в сотых насыщается
+            if (fabsf(ref) > 320.0f) continue;
+            float fix = WeatherCalculations::heatIndexC100((int16_t)t, (uint16_t)h) / 100.0f;
+            float err = fabsf(fix - ref);
+            if (err > worst) worst = err;
+            if (err > HEAT_TOLERANCE) {
+                char msg[96];
+                snprintf(msg, sizeof(msg), "T=%.2f H=%.2f fixed=%.3f float=%.3f",
+                         t / 100.0f, h / 100.0f, fix, ref);
+                TEST_FAIL_MESSAGE(msg);
+            }
+        }
+    }
+    char msg[48];
+    snprintf(msg, sizeof(msg), "heat index max error %.4f C", worst);
+    TEST_MESSAGE(msg);
+}
+
+void test_heat_index_below_threshold_is_temperature() {
+    TEST_ASSERT_EQUAL_INT16(2650, WeatherCalculations::heatIndexC100(2650, 9000));
+    TEST_ASSERT_EQUAL_INT16(-1000, WeatherCalculations::heatIndexC100(-1000, 5000));
+}
+
+void test_dew_point_edge_humidity() {
+    // 0 %RH прижимается к 0.01 %, как во float-версии, и не уходит в NaN/переполнение
+    float ref = WeatherCalculations::dewPointFloat(20.0f, 0.0f);
+    float fix = WeatherCalculations::calculateDewPoint(20.0f, 0.0f);
+    TEST_ASSERT_FLOAT_WITHIN(DEW_TOLERANCE, ref, fix);
+    // При 100 %RH точка росы равна температуре
+    TEST_ASSERT_FLOAT_WITHIN(DEW_TOLERANCE, 25.0f, WeatherCalculations::calculateDewPoint(25.0f, 100.0f));
+}
+
+void test_float_api_uses_kernels() {
+    // Обёртки округляют вход до сотых — добавляется ещё ~0.005 °C
+    for (float t = -20.0f; t <= 60.0f; t += 0.37f) {
+        for (float h = 5.0f; h <= 100.0f; h += 2.3f) {
+            TEST_ASSERT_FLOAT_WITHIN(DEW_TOLERANCE + 0.01f,
+                                     WeatherCalculations::dewPointFloat(t, h),
+                                     WeatherCalculations::calculateDewPoint(t, h));
+            float heatRef = WeatherCalculations::heatIndexFloat(t, h);
+            if (fabsf(heatRef) > 320.0f) continue;
+            TEST_ASSERT_FLOAT_WITHIN(HEAT_TOLERANCE + 0.01f, heatRef,
+                                     WeatherCalculations::calculateHeatIndex(t, h));
+        }
+    }
+}
+
+// --------------------------------------------
+// Бенчмарк: на плате — такты CPU, на хосте — наносекунды
+// --------------------------------------------
+static constexpr int BENCH_CALLS = 2000;
+static volatile int32_t g_sink;    // Чтобы компилятор не выкинул вызовы
+
+static uint32_t benchNow() {
+#ifdef ARDUINO
+    return ESP.getCycleCount();
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+template <typename Fn>
+static float benchPerCall(Fn fn) {
+    uint32_t t0 = benchNow();
+    for (int i = 0; i < BENCH_CALLS; i++) {
+        // Типичные комнатные значения, но каждый раз разные
+        int16_t  t = (int16_t)(1800 + (i * 37) % 1500);
+        uint16_t h = (uint16_t)(3000 + (i * 53) % 5000);
+        g_sink = fn(t, h);
+    }
+    return (float)(uint32_t)(benchNow() - t0) / BENCH_CALLS;
+}
+
+void test_benchmark() {
+    float dewFloat = benchPerCall([](int16_t t, uint16_t h) {
+        return (int32_t)(WeatherCalculations::dewPointFloat(t / 100.0f, h / 100.0f) * 100.0f);
+    });
+    float dewFixed = benchPerCall([](int16_t t, uint16_t h) {
+        return (int32_t)WeatherCalculations::dewPointC100(t, h);
+    });
+    float heatFloat = benchPerCall([](int16_t t, uint16_t h) {
+        return (int32_t)(WeatherCalculations::heatIndexFloat(t / 100.0f + 10.0f, h / 100.0f) * 100.0f);
+    });
+    float heatFixed = benchPerCall([](int16_t t, uint16_t h) {
+        return (int32_t)WeatherCalculations::heatIndexC100((int16_t)(t + 1000), h);
+    });
+
+#ifdef ARDUINO
+    const char* unit = "cycles";
+#else
+    const char* unit = "ns";
+#endif
+    char msg[96];
+    snprintf(msg, sizeof(msg), "dew point:  float %.0f %s, fixed %.0f %s (x%.1f)",
+             dewFloat, unit, dewFixed, unit, dewFixed > 0 ? dewFloat / dewFixed : 0.0f);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "heat index: float %.0f %s, fixed %.0f %s (x%.1f)",
+             heatFloat, unit, heatFixed, unit, heatFixed > 0 ? heatFloat / heatFixed : 0.0f);
+    TEST_MESSAGE(msg);
+}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_dew_point_matches_float);
+    RUN_TEST(test_heat_index_matches_float);
+    RUN_TEST(test_heat_index_below_threshold_is_temperature);
+    RUN_TEST(test_dew_point_edge_humidity);
+    RUN_TEST(test_float_api_uses_kernels);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    delay(2000);    // USB CDC на C3 поднимается не сразу
+    runTests();
+}
+
+void loop() {}
+#else
+int main() {
+    return runTests();
+}
+#endif
@@ -0,0 +1,188 @@
+// ============================================
+// Unit-тест DutyCycle
+// ============================================
+// RTC-кольцо сэмплов и решение о сбросе (src/duty_cycle.h) на состоянии
+// в RAM теста: затирание при полном кольце, когда поднимать WiFi (в том
+// числе после неудачного сброса) и что делают delivered() / enter().
+//
+//   pio test -e native        -f test_duty_cycle
+//   pio test -e esp32-c3-test -f test_duty_cycle
+
+#include <unity.h>
+#include <string.h>
+#include "duty_cycle.h"
+
+// Состояние как после включения питания: RTC_DATA_ATTR обнулён
+static DutyCycleState g_state;
+
+void setUp() {
+    memset(&g_state, 0, sizeof(g_state));
+    DutyCycle::begin(&g_state);
+}
+
+void tearDown() {}
+
+// Пробуждения до сброса по счёту, кольцо при этом почти пустое
+static void wakeTimes(int n) {
+    for (int i = 0; i < n; i++) DutyCycle::wake();
+}
+
+// --------------------------------------------
+// Кольцо
+// --------------------------------------------
+void test_append_keeps_order() {
+    DutyCycle::append(21.5f, 40.0f);
+    DutyCycle::append(22.25f, 41.5f);
+
+    float t, h;
+    TEST_ASSERT_EQUAL_UINT32(2, DutyCycle::count());
+    DutyCycle::sample(0, t, h);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 21.5f, t);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 40.0f, h);
+    DutyCycle::sample(1, t, h);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 22.25f, t);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 41.5f, h);
+    TEST_ASSERT_EQUAL_UINT32(0, DutyCycle::dropped());
+}
+
+void test_append_wraps_and_counts_dropped() {
+    // На 5 больше ёмкости: пять самых старых затёрты
+    const int extra = 5;
+    for (int i = 0; i < DUTY_CYCLE_BUFFER + extra; i++)
+        DutyCycle::append((float)i, (float)(i % 100));
+
+    TEST_ASSERT_EQUAL_UINT32(DUTY_CYCLE_BUFFER, DutyCycle::count());
+    TEST_ASSERT_EQUAL_UINT32(extra, DutyCycle::dropped());
+
+    float t, h;
+    DutyCycle::sample(0, t, h);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, (float)extra, t);
+    DutyCycle::sample(DUTY_CYCLE_BUFFER - 1, t, h);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, (float)(DUTY_CYCLE_BUFFER + extra - 1), t);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, (float)((DUTY_CYCLE_BUFFER + extra - 1) % 100), h);
+}
+
+void test_begin_resets_corrupt_ring() {
+    // Другая прошивка с другим DUTY_CYCLE_BUFFER оставила в RTC мусор
+    g_state.head  = DUTY_CYCLE_BUFFER + 3;
+    g_state.count = DUTY_CYCLE_BUFFER + 1;
+    g_state.wakes = 7;
+    DutyCycle::begin(&g_state);
+
+    TEST_ASSERT_EQUAL_UINT32(0, DutyCycle::count());
+    TEST_ASSERT_EQUAL_UINT32(7, DutyCycle::wakes());
+    DutyCycle::append(20.0f, 50.0f);
+    TEST_ASSERT_EQUAL_UINT32(1, DutyCycle::count());
+}
+
+// --------------------------------------------
+// Когда сбрасывать
+// --------------------------------------------
+void test_flush_due_every_n_wakes() {
+    wakeTimes(DUTY_CYCLE_FLUSH_EVERY - 1);
+    TEST_ASSERT_FALSE(DutyCycle::flushDue());
+    DutyCycle::wake();
+    TEST_ASSERT_TRUE(DutyCycle::flushDue());
+    TEST_ASSERT_EQUAL_UINT32(DUTY_CYCLE_FLUSH_EVERY, DutyCycle::wakes());
+}
+
+void test_flush_due_when_ring_nearly_full() {
+    for (int i = 0; i < DUTY_CYCLE_BUFFER - DUTY_CYCLE_FLUSH_MARGIN - 1; i++)
+        DutyCycle::append(20.0f, 50.0f);
+    TEST_ASSERT_FALSE(DutyCycle::flushDue());
+
+    // Осталось DUTY_CYCLE_FLUSH_MARGIN мест — не ждём очередного по счёту
+    DutyCycle::append(20.0f, 50.0f);
+    TEST_ASSERT_TRUE(DutyCycle::flushDue());
+}
+
+void test_failed_flush_waits_for_next_scheduled() {
+    for (int i = 0; i < DUTY_CYCLE_BUFFER; i++)
+        DutyCycle::append(20.0f, 50.0f);
+    TEST_ASSERT_TRUE(DutyCycle::flushDue());
+
+    // Сброс без WiFi: delivered() не звали, пачка осталась в кольце
+    DutyCycle::enter();
+    TEST_ASSERT_TRUE(g_state.flushFailed);
+    TEST_ASSERT_EQUAL_UINT32(DUTY_CYCLE_BUFFER, DutyCycle::count());
+
+    // Полное кольцо больше не поднимает радио на каждом пробуждении...
+    wakeTimes(DUTY_CYCLE_FLUSH_EVERY - 1);
+    DutyCycle::append(20.0f, 50.0f);
+    TEST_ASSERT_FALSE(DutyCycle::flushDue());
+
+    // ...только очередной сброс по счёту
+    DutyCycle::wake();
+    TEST_ASSERT_TRUE(DutyCycle::flushDue());
+}
+
+// --------------------------------------------
+// Сброс
+// --------------------------------------------
+void test_delivered_clears_ring() {
+    DutyCycle::append(20.0f, 50.0f);
+    DutyCycle::append(21.0f, 51.0f);
+    DutyCycle::delivered();
+    TEST_ASSERT_EQUAL_UINT32(0, DutyCycle::count());
+    TEST_ASSERT_EQUAL_UINT32(1, DutyCycle::flushes());
+
+    // Пустое кольцо — не сброс: WiFi поднимался повторно без новых данных
+    DutyCycle::delivered();
+    TEST_ASSERT_EQUAL_UINT32(1, DutyCycle::flushes());
+}
+
+void test_enter_after_delivery() {
+    wakeTimes(DUTY_CYCLE_FLUSH_EVERY);
+    DutyCycle::append(20.0f, 50.0f);
+    DutyCycle::delivered();
+    DutyCycle::enter();
+
+    TEST_ASSERT_TRUE(DutyCycle::active());
+    TEST_ASSERT_FALSE(g_state.flushFailed);
+    TEST_ASSERT_EQUAL_UINT32(0, g_state.sinceFlush);
+    TEST_ASSERT_FALSE(DutyCycle::flushDue());
+    // Счётчик пробуждений копится с включения питания
+    TEST_ASSERT_EQUAL_UINT32(DUTY_CYCLE_FLUSH_EVERY, DutyCycle::wakes());
+}
+
+void test_delivery_after_failed_flush_recovers() {
+    DutyCycle::append(20.0f, 50.0f);
+    DutyCycle::enter();
+    TEST_ASSERT_TRUE(g_state.flushFailed);
+
+    // Следующий сброс дошёл — признак неудачи снимается
+    wakeTimes(DUTY_CYCLE_FLUSH_EVERY);
+    DutyCycle::delivered();
+    DutyCycle::enter();
+    TEST_ASSERT_FALSE(g_state.flushFailed);
+    TEST_ASSERT_EQUAL_UINT32(1, DutyCycle::flushes());
+}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_append_keeps_order);
+    RUN_TEST(test_append_wraps_and_counts_dropped);
+    RUN_TEST(test_begin_resets_corrupt_ring);
+    RUN_TEST(test_flush_due_every_n_wakes);
+    RUN_TEST(test_flush_due_when_ring_nearly_full);
+    RUN_TEST(test_failed_flush_waits_for_next_scheduled);
+    RUN_TEST(test_delivered_clears_ring);
+    RUN_TEST(test_enter_after_delivery);
+    RUN_TEST(test_delivery_after_failed_flush_recovers);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000);    // USB CDC на C3 поднимается не сразу
+    runTests();
+}
+
+void loop() {}
+#else
+int main() {
+    return runTests();
+}
+#endif
@@ -0,0 +1,218 @@
+// ============================================
+// Unit-тест LogRing
+// ============================================
+// Кольцо строк WS-лога (src/log_ring.h) на маленьком буфере, где
+// затирание и обрезка наступают за несколько строк: отставший читатель,
+// строка длиннее кадра и граница истории посреди строки.
+//
+//   pio test -e native -f test_log_ring
+
+#include <unity.h>
+#include <string.h>
+#include "log_ring.h"
+
+// 64 байта: строки "line a\n" по 7 байт, влезает 9; MAX_LINE = 16
+typedef LogRing<64> Ring;
+
+void setUp() {}
+void tearDown() {}
+
+static void append(Ring& ring, const char* s) {
+    ring.append(s, strlen(s));
+}
+
+// peek() в строку с '\0' — удобно сравнивать
+static size_t peekStr(Ring& ring, Ring::Reader& r, char* out, size_t cap, uint32_t& dropped) {
+    size_t n = ring.peek(r, out, cap - 1, dropped);
+    out[n] = '\0';
+    return n;
+}
+
+// --------------------------------------------
+// Отставший читатель
+// --------------------------------------------
+void test_lagging_reader_skips_overwritten_lines() {
+    Ring ring;
+    Ring::Reader r = ring.reader();
+
+    char line[16];
+    for (int i = 0; i < 12; i++) {
+        snprintf(line, sizeof(line), "line %c", 'a' + i);
+        append(ring, line);
+    }
+    TEST_ASSERT_EQUAL_UINT32(12, ring.lines());
+    TEST_ASSERT_EQUAL_UINT32(3, ring.evicted());
+
+    // Читатель стоял на первой строке: a-c затёрты, отдаются d-l
+    char out[65];
+    uint32_t dropped;
+    size_t n = peekStr(ring, r, out, sizeof(out), dropped);
+    TEST_ASSERT_EQUAL_UINT32(3, dropped);
+    TEST_ASSERT_EQUAL_size_t(9 * 7, n);
+    TEST_ASSERT_EQUAL_STRING_LEN("line d\n", out, 7);
+    TEST_ASSERT_EQUAL_STRING("line l\n", out + n - 7);
+
+    // Пропуск сообщается один раз: после commit() читатель догнал кольцо
+    ring.commit(r, n);
+    TEST_ASSERT_FALSE(ring.pending(r));
+    append(ring, "next");
+    peekStr(ring, r, out, sizeof(out), dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, dropped);
+    TEST_ASSERT_EQUAL_STRING("next\n", out);
+}
+
+void test_unsent_frame_keeps_cursor() {
+    Ring ring;
+    Ring::Reader r = ring.reader();
+    append(ring, "a");
+    append(ring, "b");
+
+    // Кадр не ушёл — commit() не зовут, следующий peek() отдаёт то же
+    char out[65];
+    uint32_t dropped;
+    peekStr(ring, r, out, sizeof(out), dropped);
+    TEST_ASSERT_EQUAL_STRING("a\nb\n", out);
+    peekStr(ring, r, out, sizeof(out), dropped);
+    TEST_ASSERT_EQUAL_STRING("a\nb\n", out);
+    TEST_ASSERT_TRUE(ring.pending(r));
+}
+
+// --------------------------------------------
+// Длинные строки
+// --------------------------------------------
+void test_line_longer_than_max_is_truncated() {
+    Ring ring;
+    Ring::Reader r = ring.reader();
+    append(ring, "0123456789abcdefXYZ");   // 19 > MAX_LINE
+
+    char out[65];
+    uint32_t dropped;
+    peekStr(ring, r, out, sizeof(out), dropped);
+    TEST_ASSERT_EQUAL_STRING("0123456789abcdef\n", out);
+}
+
+void test_line_longer_than_frame_is_cut_and_tail_skipped() {
+    Ring ring;
+    Ring::Reader r = ring.reader();
+    append(ring, "0123456789abcdef");
+    append(ring, "short");
+
+    // Кадр на 8 байт: первая строка в него не влезает целиком — уходит
+    // обрезанной, а не блокирует читателя
+    char out[9];
+    uint32_t dropped;
+    size_t n = peekStr(ring, r, out, sizeof(out), dropped);
+    TEST_ASSERT_EQUAL_size_t(8, n);
+    TEST_ASSERT_EQUAL_STRING("01234567", out);
+
+    // commit() пропускает хвост обрезанной строки целиком
+    ring.commit(r, n);
+    TEST_ASSERT_EQUAL_UINT32(1, r.line);
+    n = peekStr(ring, r, out, sizeof(out), dropped);
+    TEST_ASSERT_EQUAL_STRING("short\n", out);
+    ring.commit(r, n);
+    TEST_ASSERT_EQUAL_UINT32(2, r.line);
+    TEST_ASSERT_FALSE(ring.pending(r));
+}
+
+void test_frame_holds_only_whole_lines() {
+    Ring ring;
+    Ring::Reader r = ring.reader();
+    append(ring, "abc");
+    append(ring, "defgh");
+
+    // "abc\n" влезает, "defgh\n" уже нет — ждёт следующего кадра
+    char out[9];
+    uint32_t dropped;
+    size_t n = peekStr(ring, r, out, sizeof(out), dropped);
+    TEST_ASSERT_EQUAL_STRING("abc\n", out);
+    ring.commit(r, n);
+    peekStr(ring, r, out, sizeof(out), dropped);
+    TEST_ASSERT_EQUAL_STRING("defgh\n", out);
+}
+
+// --------------------------------------------
+// История для нового читателя
+// --------------------------------------------
+void test_backlog_boundary_mid_line_starts_at_next_line() {
+    Ring ring;
+    append(ring, "aaaa");   // [0, 5)
+    append(ring, "bbbb");   // [5, 10)
+    append(ring, "cccc");   // [10, 15)
+
+    // Последние 7 байт начинаются с позиции 8 — внутри "bbbb\n"
+    Ring::Reader r = ring.reader(7);
+    TEST_ASSERT_EQUAL_UINT32(10, r.pos);
+    TEST_ASSERT_EQUAL_UINT32(2, r.line);
+
+    char out[65];
+    uint32_t dropped;
+    peekStr(ring, r, out, sizeof(out), dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, dropped);
+    TEST_ASSERT_EQUAL_STRING("cccc\n", out);
+}
+
+void test_backlog_boundary_on_line_start() {
+    Ring ring;
+    append(ring, "aaaa");
+    append(ring, "bbbb");
+    append(ring, "cccc");
+
+    // Ровно две последние строки
+    Ring::Reader r = ring.reader(10);
+    TEST_ASSERT_EQUAL_UINT32(1, r.line);
+
+    char out[65];
+    uint32_t dropped;
+    peekStr(ring, r, out, sizeof(out), dropped);
+    TEST_ASSERT_EQUAL_STRING("bbbb\ncccc\n", out);
+}
+
+void test_backlog_larger_than_ring_returns_everything() {
+    Ring ring;
+    char line[16];
+    for (int i = 0; i < 12; i++) {
+        snprintf(line, sizeof(line), "line %c", 'a' + i);
+        append(ring, line);
+    }
+
+    // История не старше хвоста кольца, потерь у нового читателя нет
+    Ring::Reader r = ring.reader(1000);
+    TEST_ASSERT_EQUAL_UINT32(ring.evicted(), r.line);
+
+    char out[65];
+    uint32_t dropped;
+    size_t n = peekStr(ring, r, out, sizeof(out), dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, dropped);
+    TEST_ASSERT_EQUAL_STRING_LEN("line d\n", out, 7);
+    ring.commit(r, n);
+    TEST_ASSERT_EQUAL_UINT32(ring.lines(), r.line);
+}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_lagging_reader_skips_overwritten_lines);
+    RUN_TEST(test_unsent_frame_keeps_cursor);
+    RUN_TEST(test_line_longer_than_max_is_truncated);
+    RUN_TEST(test_line_longer_than_frame_is_cut_and_tail_skipped);
+    RUN_TEST(test_frame_holds_only_whole_lines);
+    RUN_TEST(test_backlog_boundary_mid_line_starts_at_next_line);
+    RUN_TEST(test_backlog_boundary_on_line_start);
+    RUN_TEST(test_backlog_larger_than_ring_returns_everything);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+void setup() {
+    delay(2000);    // USB CDC на C3 поднимается не сразу
+    runTests();
+}
+
+void loop() {}
+#else
+int main() {
+    return runTests();
+}
+#endif
@@ -0,0 +1,231 @@
+// ============================================
+// Unit-тест Scheduler
+// ============================================
+// Планировщик (src/scheduler.h) на виртуальных часах стенда: millis()
+// двигает только sim::advanceMs(), поэтому сроки проверяются точно до
+// миллисекунды — сетка, догон после пересыпа, разовые задачи и
+// setPeriod() при смене питания.
+//
+//   pio test -e native -f test_scheduler   # только хост: нужен sim.h
+
+#include <unity.h>
+#include <limits.h>
+#include <Arduino.h>
+#include "scheduler.h"
+#include "sim.h"
+
+// Задачи — обычные функции без захвата, поэтому счётчики глобальные
+static int g_runsA = 0;
+static int g_runsB = 0;
+
+static void taskA() { g_runsA++; }
+static void taskB() { g_runsB++; }
+
+// Начать тест с круглого времени: сетка от него считается в уме
+static unsigned long alignTo(unsigned long stepMs) {
+    unsigned long rest = millis() % stepMs;
+    if (rest) sim::advanceMs(stepMs - rest);
+    return millis();
+}
+
+void setUp() {
+    g_runsA = 0;
+    g_runsB = 0;
+}
+
+void tearDown() {}
+
+// --------------------------------------------
+// Сетка
+// --------------------------------------------
+void test_period_runs_on_grid() {
+    unsigned long t0 = alignTo(1000);
+    sim::advanceMs(7);
+
+    // Первый запуск — через период от регистрации, дальше — по сетке
+    Scheduler s;
+    s.every(LoopPhase::WEB, 10, taskA);
+    TEST_ASSERT_EQUAL_UINT32(10, s.msUntilNext());
+
+    sim::advanceMs(10);   // t0 + 17
+    s.runDue();
+    TEST_ASSERT_EQUAL(1, g_runsA);
+    TEST_ASSERT_EQUAL_UINT32(3, s.msUntilNext());   // t0 + 20, а не t0 + 27
+
+    // Задача опоздала на 4 мс — следующий срок всё равно на сетке
+    sim::advanceMs(7);    // t0 + 24
+    s.runDue();
+    TEST_ASSERT_EQUAL(2, g_runsA);
+    TEST_ASSERT_EQUAL_UINT32(t0 + 30 - millis(), s.msUntilNext());
+}
+
+void test_multiple_periods_wake_together() {
+    alignTo(1000);
+
+    Scheduler s;
+    s.every(LoopPhase::BUTTON, 20, 0, taskA);
+    s.every(LoopPhase::WEB, 40, 0, taskB);
+    s.runDue();
+    TEST_ASSERT_EQUAL(1, g_runsA);
+    TEST_ASSERT_EQUAL(1, g_runsB);
+
+    // Каждый второй срок кнопки совпадает со сроком веба — одно пробуждение
+    for (int i = 0; i < 4; i++) {
+        sim::advanceMs(s.msUntilNext());
+        s.runDue();
+    }
+    TEST_ASSERT_EQUAL(5, g_runsA);
+    TEST_ASSERT_EQUAL(3, g_runsB);
+    TEST_ASSERT_EQUAL_UINT32(0, millis() % 40);
+}
+
+// --------------------------------------------
+// Догон после пересыпа
+// --------------------------------------------
+void test_oversleep_catches_up_once() {
+    unsigned long t0 = alignTo(1000);
+
+    Scheduler s;
+    s.every(LoopPhase::DISPLAY, 10, 0, taskA);
+    s.runDue();
+    TEST_ASSERT_EQUAL(1, g_runsA);
+
+    // Проспали пять с половиной периодов: один запуск, не шесть
+    sim::advanceMs(55);
+    s.runDue();
+    TEST_ASSERT_EQUAL(2, g_runsA);
+    s.runDue();
+    TEST_ASSERT_EQUAL(2, g_runsA);
+
+    // И следующий срок — ближайший узел сетки, а не "через период"
+    TEST_ASSERT_EQUAL_UINT32(5, s.msUntilNext());
+    TEST_ASSERT_EQUAL_UINT32(t0 + 60, millis() + s.msUntilNext());
+}
+
+void test_overdue_reports_zero_wait() {
+    alignTo(1000);
+
+    Scheduler s;
+    s.every(LoopPhase::STATUS, 100, taskA);
+    sim::advanceMs(150);
+    TEST_ASSERT_EQUAL_UINT32(0, s.msUntilNext());
+}
+
+// --------------------------------------------
+// Разовые задачи
+// --------------------------------------------
+static Scheduler* g_self = nullptr;
+static int        g_selfId = -1;
+
+// Опрос AHT10: пока BUSY, взводит себя снова
+static void pollUntilThird() {
+    if (++g_runsA < 3) g_self->after(g_selfId, 5);
+}
+
+void test_once_sleeps_until_armed() {
+    alignTo(1000);
+
+    Scheduler s;
+    int t = s.once(LoopPhase::SENSOR, taskA);
+    TEST_ASSERT_EQUAL_UINT32(ULONG_MAX, s.msUntilNext());
+    sim::advanceMs(1000);
+    s.runDue();
+    TEST_ASSERT_EQUAL(0, g_runsA);
+
+    s.after(t, 80);
+    TEST_ASSERT_EQUAL_UINT32(80, s.msUntilNext());
+    sim::advanceMs(80);
+    s.runDue();
+    TEST_ASSERT_EQUAL(1, g_runsA);
+
+    // Отработала — снова спит
+    TEST_ASSERT_EQUAL_UINT32(ULONG_MAX, s.msUntilNext());
+    sim::advanceMs(1000);
+    s.runDue();
+    TEST_ASSERT_EQUAL(1, g_runsA);
+
+    // now() — в ближайшем runDue()
+    s.now(t);
+    TEST_ASSERT_EQUAL_UINT32(0, s.msUntilNext());
+    s.runDue();
+    TEST_ASSERT_EQUAL(2, g_runsA);
+}
+
+void test_once_can_rearm_itself() {
+    alignTo(1000);
+
+    Scheduler s;
+    g_self   = &s;
+    g_selfId = s.once(LoopPhase::SENSOR, pollUntilThird);
+    s.now(g_selfId);
+
+    // Срок снимается до запуска, поэтому after() изнутри задачи не теряется
+    for (int i = 0; i < 10 && s.msUntilNext() != ULONG_MAX; i++) {
+        sim::advanceMs(s.msUntilNext());
+        s.runDue();
+    }
+    TEST_ASSERT_EQUAL(3, g_runsA);
+    g_self = nullptr;
+}
+
+// --------------------------------------------
+// Смена периода
+// --------------------------------------------
+void test_set_period_pulls_deadline_earlier() {
+    unsigned long t0 = alignTo(1000);
+
+    Scheduler s;
+    int t = s.every(LoopPhase::WEB, 40, 0, taskA);
+    s.runDue();                       // Следующий — t0 + 40
+    sim::advanceMs(3);
+
+    // USB воткнули: 40 → 10 мс, ждать старый срок незачем
+    s.setPeriod(t, 10);
+    TEST_ASSERT_EQUAL_UINT32(t0 + 10, millis() + s.msUntilNext());
+    sim::advanceMs(s.msUntilNext());
+    s.runDue();
+    TEST_ASSERT_EQUAL(2, g_runsA);
+    TEST_ASSERT_EQUAL_UINT32(10, s.msUntilNext());
+}
+
+void test_set_period_longer_keeps_deadline() {
+    unsigned long t0 = alignTo(1000);
+
+    Scheduler s;
+    int t = s.every(LoopPhase::WEB, 10, 0, taskA);
+    s.runDue();                       // Следующий — t0 + 10
+    sim::advanceMs(3);
+
+    // Батарея: 10 → 40 мс. Уже назначенный срок остаётся, дальше — новая сетка
+    s.setPeriod(t, 40);
+    TEST_ASSERT_EQUAL_UINT32(t0 + 10, millis() + s.msUntilNext());
+    sim::advanceMs(s.msUntilNext());
+    s.runDue();
+    TEST_ASSERT_EQUAL_UINT32(t0 + 40, millis() + s.msUntilNext());
+}
+
+void test_table_full() {
+    Scheduler s;
+    for (int i = 0; i < Scheduler::MAX_TASKS; i++)
+        TEST_ASSERT_EQUAL(i, s.every(LoopPhase::STATUS, 1000, taskB));
+    TEST_ASSERT_EQUAL(-1, s.every(LoopPhase::STATUS, 1000, taskB));
+    TEST_ASSERT_EQUAL(-1, s.once(LoopPhase::STATUS, taskB));
+}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_period_runs_on_grid);
+    RUN_TEST(test_multiple_periods_wake_together);
+    RUN_TEST(test_oversleep_catches_up_once);
+    RUN_TEST(test_overdue_reports_zero_wait);
+    RUN_TEST(test_once_sleeps_until_armed);
+    RUN_TEST(test_once_can_rearm_itself);
+    RUN_TEST(test_set_period_pulls_deadline_earlier);
+    RUN_TEST(test_set_period_longer_keeps_deadline);
+    RUN_TEST(test_table_full);
+    return UNITY_END();
+}
+
+int main() {
+    return runTests();
+}
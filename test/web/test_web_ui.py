@@ -364,6 +364,42 @@ class TestWebSocket:
         
         # Должны быть какие-то логи
         assert logs.count() > 0
+    
+    def test_push_replaces_polling(self, page: Page, base_url):
+        """With a live WebSocket the page should stop polling data endpoints"""
+        page.wait_for_timeout(3000)
+        expect(page.locator("#wsStatus")).to_have_class(re.compile("ws-connected"))
+        
+        polled = []
+        page.on("request", lambda req:
+            polled.append(req.url) if re.search(r"/(data|stats)$", req.url) else None
+        )
+        # Дольше двух интервалов опроса (10 с) и одного чтения датчика (30 с)
+        page.wait_for_timeout(35000)
+        
+        assert polled == [], f"Polled despite WS push: {polled}"
+        expect(page.locator("#temperature")).not_to_have_text("--")
+    
+    def test_snapshots_not_logged(self, page: Page):
+        """Typed snapshots should not show up as log lines"""
+        page.wait_for_timeout(5000)
+        
+        snapshot_lines = page.locator("#logConsole .log-line", has_text='{"t":')
+        assert snapshot_lines.count() == 0
+    
+    def test_batched_logs_split_into_lines(self, page: Page):
+        """A coalesced log frame should render one log line per '\\n'"""
+        page.wait_for_timeout(5000)
+        
+        for i in range(page.locator("#logConsole .log-line").count()):
+            assert "\n" not in page.locator("#logConsole .log-line").nth(i).inner_text()
+    
+    def test_log_history_replayed(self, page: Page):
+        """A fresh connection should receive earlier log lines, not just the greeting"""
+        page.wait_for_timeout(5000)
+        
+        server_lines = page.locator("#logConsole .log-line", has_text="-------------------------")
+        assert server_lines.count() >= 1  # printStatus()/setup() separator
 
 # ═══════════════════════════════════════════════════════════════
 # Accessibility Tests
@@ -423,6 +459,33 @@ class TestPerformance:
         
         # Не должно быть критических ошибок
         assert len(console_errors) == 0, f"Console errors: {console_errors}"
+    
+    def test_chart_first_render(self, page: Page):
+        """Combined chart should draw soon after navigation"""
+        page.reload()
+        page.wait_for_function(
+            "performance.getEntriesByName('chart-first-render').length > 0",
+            timeout=10000
+        )
+        ms = page.evaluate(
+            "performance.getEntriesByName('chart-first-render')[0].startTime"
+        )
+        print(f"\nChart first render: {ms:.0f} ms after navigation start")
+        
+        # Отрисовщик встроен в страницу — ждём только /history
+        assert ms < 2000, f"Chart first render too slow: {ms:.0f} ms"
+    
+    def test_no_external_requests(self, page: Page, base_url):
+        """Dashboard should work on a network without internet"""
+        external = []
+        page.on("request", lambda req:
+            external.append(req.url) if not req.url.startswith(base_url) else None
+        )
+        
+        page.reload()
+        page.wait_for_load_state("networkidle")
+        
+        assert external == [], f"External requests: {external}"
 
 
 if __name__ == "__main__":
@@ -0,0 +1,90 @@
+"""
+Сборка страницы дашборда: src/html_pages.h -> src/html_page_gz.h
+
+Страница по-прежнему правится в html_pages.h (raw-литерал HTML_PAGE).
+Перед компиляцией скрипт вырезает из неё комментарии и отступы, сжимает
+gzip и пишет PROGMEM-массив с готовым ETag (хэш содержимого). Прошивка
+отдаёт массив как есть с Content-Encoding: gzip — без распаковки на чипе.
+
+PlatformIO вызывает скрипт сам (extra_scripts = pre:tools/build_page.py),
+вручную — python3 tools/build_page.py
+"""
+
+import gzip
+import hashlib
+import os
+import re
+
+try:
+    Import("env")  # noqa: F821 — есть только внутри PlatformIO
+    PROJECT_DIR = env["PROJECT_DIR"]  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = os.path.join(PROJECT_DIR, "src", "html_pages.h")
+OUTPUT = os.path.join(PROJECT_DIR, "src", "html_page_gz.h")
+
+RAW_LITERAL = re.compile(r'HTML_PAGE\[\]\s+PROGMEM\s*=\s*R"rawliteral\((.*?)\)rawliteral"', re.S)
+
+
+def minify(html):
+    # В странице нет <pre> и многострочных JS-строк, поэтому безопасно:
+    # комментарии HTML и CSS, отступы, пустые строки. Переводы строк
+    # остаются — на них держится автоподстановка ';' в JS.
+    html = re.sub(r"<!--.*?-->", "", html, flags=re.S)
+    html = re.sub(r"/\*.*?\*/", "", html, flags=re.S)
+    lines = (line.strip() for line in html.splitlines())
+    return "\n".join(line for line in lines if line)
+
+
+def render(raw, packed, etag):
+    rows = []
+    for i in range(0, len(packed), 16):
+        rows.append("    " + ", ".join("0x%02x" % b for b in packed[i:i + 16]) + ",")
+    return (
+        "// Сгенерировано tools/build_page.py из html_pages.h — не редактировать\n"
+        "#ifndef HTML_PAGE_GZ_H\n"
+        "#define HTML_PAGE_GZ_H\n"
+        "\n"
+        "#include <Arduino.h>\n"
+        "\n"
+        "inline constexpr size_t HTML_PAGE_RAW_SIZE = %d;\n"
+        "inline constexpr size_t HTML_PAGE_GZ_SIZE  = %d;\n"
+        "inline constexpr char   HTML_PAGE_ETAG[]   = \"\\\"%s\\\"\";\n"
+        "\n"
+        "const uint8_t HTML_PAGE_GZ[] PROGMEM = {\n"
+        "%s\n"
+        "};\n"
+        "\n"
+        "#endif // HTML_PAGE_GZ_H\n"
+    ) % (len(raw), len(packed), etag, "\n".join(rows))
+
+
+def main():
+    with open(SOURCE, encoding="utf-8") as f:
+        match = RAW_LITERAL.search(f.read())
+    if not match:
+        raise SystemExit("build_page: HTML_PAGE raw literal not found in " + SOURCE)
+
+    raw = match.group(1).encode("utf-8")
+    minified = minify(match.group(1)).encode("utf-8")
+    # mtime=0 — одинаковый вход даёт байт-в-байт одинаковый выход
+    packed = gzip.compress(minified, compresslevel=9, mtime=0)
+    etag = hashlib.sha256(packed).hexdigest()[:16]
+
+    text = render(raw, packed, etag)
+    try:
+        with open(OUTPUT, encoding="utf-8") as f:
+            unchanged = f.read() == text
+    except OSError:
+        unchanged = False
+    if not unchanged:
+        # Перезапись без изменений пересобрала бы web_server.cpp впустую
+        with open(OUTPUT, "w", encoding="utf-8") as f:
+            f.write(text)
+
+    print("Dashboard page: %d B raw -> %d B minified -> %d B gzip (%.1f%%), ETag %s"
+          % (len(raw), len(minified), len(packed), 100.0 * len(packed) / len(raw), etag))
+
+
+main()